@@ -1,136 +1,158 @@
 // Id: 211696521 Mail: galh2011@icloud.com
 #include "Algorithms.hpp"
+#include "ResultCache.hpp"
 #include <queue>
-#include <stack>
-#include <limits>
 #include <algorithm>
+#include <cstdint>
+#include <stdexcept>
 
 using namespace std;
 
 namespace ariel
 {
+    // The four whole-graph queries below are memoized on the graph's version: asking again before the
+    // graph changes returns the stored answer without another traversal.
     bool Algorithms::isConnected(const Graph &g)
     {
-        const std::vector<std::vector<int>> &adjacencyMatrix = g.getAdjacencyMatrix();
-        int numVertices = g.getVertices();
-
-        std::vector<bool> visited(static_cast<std::vector<bool>::size_type>(numVertices), false);
+        // Direction-optimizing BFS from vertex 0, spread over the shared thread pool
+        return ResultCache::shared().lookup(ResultCache::Query::IsConnected, g, 0, [&g]()
+                                            { return std::string(connected(g) ? "1" : "0"); }) == "1";
+    }
 
-        // Starts DFS from vertex 0
-        return dfs(adjacencyMatrix, visited, 0);
+    bool Algorithms::isStronglyConnected(const Graph &g)
+    {
+        return stronglyConnected(g);
     }
 
     string Algorithms::shortestPath(const Graph &g, int start, int end)
     {
-        const auto &adjacencyMatrix = g.getAdjacencyMatrix();
-        int numVertices = g.getVertices();
+        return shortestPathIn(g, start, end);
+    }
 
-        // Initialize a vector to mark visited vertices
-        std::vector<bool> visited(static_cast<std::vector<bool>::size_type>(numVertices), false);
+    std::string Algorithms::isContainsCycle(const Graph &g, CycleMode mode)
+    {
+        return ResultCache::shared().lookup(ResultCache::Query::IsContainsCycle, g, static_cast<int>(mode), [&g, mode]()
+                                            { return describeCycle(cycleIn(g, mode)); });
+    }
 
-        // Perform DFS from the start vertex
-        if (!dfs(adjacencyMatrix, visited, start) || Algorithms::negativeCycle(g) != "No negative cycle found.")
-        {
-            // If the end vertex is not reachable from the start vertex, return "-1"
-            return "-1";
-        }
+    std::vector<int> Algorithms::findCycle(const Graph &g, CycleMode mode)
+    {
+        return cycleIn(g, mode);
+    }
 
-        // Reconstruct the shortest path
-        std::string path = std::to_string(end);
-        while (end != start)
-        {
-            // Find the parent vertex of the current vertex on the shortest path
-            for (std::vector<int>::size_type i = 0; i < static_cast<std::vector<int>::size_type>(numVertices); ++i)
-            {
-                if (adjacencyMatrix[i][static_cast<std::vector<int>::size_type>(end)] && visited[i])
-                {
-                    path = std::to_string(i) + "->" + path;
-                    end = static_cast<int>(i);
-                    break;
-                }
-            }
-        }
+    std::string Algorithms::isBipartite(const Graph &g)
+    {
+        return ResultCache::shared().lookup(ResultCache::Query::IsBipartite, g, 0, [&g]()
+                                            { return bipartitionOf(g); });
+    }
 
-        return path;
+    std::string Algorithms::negativeCycle(const Graph &g)
+    {
+        return ResultCache::shared().lookup(ResultCache::Query::NegativeCycle, g, 0, [&g]()
+                                            { return computeNegativeCycle(g); });
     }
 
-    std::string Algorithms::isContainsCycle(const Graph &g)
+    std::string Algorithms::computeNegativeCycle(const Graph &g)
     {
-        const auto &adjacencyMatrix = g.getAdjacencyMatrix();
-        int numVertices = g.getVertices();
+        // Searches the whole graph, not only what vertex 0 reaches. Mostly-full matrices are relaxed a
+        // row at a time with the vector kernel; everything else goes edge by edge over the CSR.
+        return describeNegativeCycle(ShortestPaths::preferDense(g) ? ShortestPaths::findNegativeCycleDense(g.getAdjacencyMatrix())
+                                                                   : ShortestPaths::findNegativeCycle(g.getCsr()));
+    }
 
-        // Mark all the vertices as not visited
-        std::vector<bool> visited(static_cast<size_t>(numVertices), false);
+    std::vector<int> AlgorithmsBase::findCycle(const CsrStructure &adjacency, const CsrStructure *reverse)
+    {
+        int numVertices = adjacency.getVertices();
 
-        // Stores the cycle vertices if found
+        // 0 = not visited, 1 = on the DFS stack, 2 = finished
+        std::vector<char> color(static_cast<size_t>(numVertices), 0);
+        std::vector<int> parent(static_cast<size_t>(numVertices), -1);
         std::vector<int> cycle;
 
-        // Call the recursive helper function to detect cycle in different DFS trees
-        for (int u = 0; u < numVertices; u++)
+        // Explicit DFS stack: the vertex and its next unread position in the out- and in-edge rows
+        struct Frame
+        {
+            int vertex;
+            size_t out;
+            size_t in;
+        };
+        std::vector<Frame> stack;
+
+        // Start a DFS from every vertex not reached by an earlier one
+        for (int root = 0; root < numVertices; root++)
         {
-            // Don't recur for u if it is already visited
-            if (!visited[static_cast<size_t>(u)])
+            if (color[static_cast<size_t>(root)] != 0)
+            {
+                continue;
+            }
+            color[static_cast<size_t>(root)] = 1;
+            stack.push_back({root, adjacency.rowBegin(root), reverse ? reverse->rowBegin(root) : 0});
+
+            while (!stack.empty())
             {
-                if (isContainsCycleH(adjacencyMatrix, u, visited, -1, cycle))
+                Frame &frame = stack.back();
+                int vertex = frame.vertex;
+
+                // Next neighbour in increasing order; in undirected mode the two sorted rows are merged so
+                // that a pair of opposite edges is seen once
+                int next = -1;
+                bool hasOut = frame.out < adjacency.rowEnd(vertex);
+                bool hasIn = reverse && frame.in < reverse->rowEnd(vertex);
+                if (hasOut && (!hasIn || adjacency.target(frame.out) <= reverse->target(frame.in)))
                 {
-                    // Construct the output string for the cycle
-                    std::string cycleStr = "The cycle is: ";
-                    for (size_t i = 0; i < cycle.size(); ++i)
+                    next = adjacency.target(frame.out++);
+                    if (hasIn && reverse->target(frame.in) == next)
                     {
-                        cycleStr += std::to_string(cycle[i]);
-                        if (i != cycle.size() - 1)
-                            cycleStr += "->";
+                        ++frame.in;
                     }
-                    return cycleStr;
                 }
-            }
-        }
-        return "0";
-    }
+                else if (hasIn)
+                {
+                    next = reverse->target(frame.in++);
+                }
 
-    bool Algorithms::isContainsCycleH(const std::vector<std::vector<int>> &adjacencyMatrix, int vertex, std::vector<bool> &visited, int parent, std::vector<int> &cycle)
-    {
-        // Mark the current node as visited
-        visited[static_cast<size_t>(vertex)] = true;
+                if (next == -1)
+                {
+                    // All neighbours done
+                    color[static_cast<size_t>(vertex)] = 2;
+                    stack.pop_back();
+                    continue;
+                }
 
-        // Recur for all the vertices adjacent to this vertex
-        for (size_t i = 0; i < adjacencyMatrix[static_cast<size_t>(vertex)].size(); ++i)
-        {
-            // If an adjacent vertex is not visited, then recur for that adjacent
-            if (adjacencyMatrix[static_cast<size_t>(vertex)][i] && !visited[i])
-            {
-                if (isContainsCycleH(adjacencyMatrix, static_cast<int>(i), visited, vertex, cycle))
+                size_t i = static_cast<size_t>(next);
+                if (color[i] == 0)
                 {
-                    // If a cycle is found, add the current vertex to the cycle
-                    cycle.push_back(static_cast<int>(vertex));
-                    return true;
+                    color[i] = 1;
+                    parent[i] = vertex;
+                    stack.push_back({next, adjacency.rowBegin(next), reverse ? reverse->rowBegin(next) : 0});
+                }
+                // A neighbour still on the stack closes a cycle, unless it is just the edge back to the parent
+                else if (color[i] == 1 && (!reverse || next != parent[static_cast<size_t>(vertex)]))
+                {
+                    for (int v = vertex; v != next; v = parent[static_cast<size_t>(v)])
+                    {
+                        cycle.push_back(v);
+                    }
+                    cycle.push_back(next);
+                    std::reverse(cycle.begin(), cycle.end());
+                    return cycle;
                 }
-            }
-            // If an adjacent vertex is visited and is not the parent of the current vertex, then there exists a cycle in the graph
-            else if (adjacencyMatrix[static_cast<size_t>(vertex)][i] && i != static_cast<size_t>(parent))
-            {
-                // Construct the cycle
-                cycle.push_back(static_cast<int>(vertex));
-                // cycle.push_back(static_cast<int>(i));
-                return true;
             }
         }
-        return false;
+        return cycle;
     }
 
-    std::string Algorithms::isBipartite(const Graph &g)
+    bool AlgorithmsBase::twoColor(const CsrStructure &adjacency, std::vector<int> &setA, std::vector<int> &setB)
     {
-        const auto &adjacencyMatrix = g.getAdjacencyMatrix();
-        int numVertices = g.getVertices();
+        int numVertices = adjacency.getVertices();
+        setA.clear();
+        setB.clear();
 
         // Create a color array to store colors assigned to all vertices
         // The value '-1' of colorArr[i] is used to indicate that no color is assigned to vertex 'i'.
         // The value 1 is used to indicate the first color is assigned and value 0 indicates the second color is assigned.
         std::vector<int> colorArr(static_cast<size_t>(numVertices), -1);
 
-        // Stores vertices in two different sets based on their color
-        std::vector<int> setA, setB;
-
         // Run BFS for each component if not already colored
         for (int i = 0; i < numVertices; ++i)
         {
@@ -152,15 +174,12 @@ namespace ariel
                     int u = q.front();
                     q.pop();
 
-                    // Return false if there is a self-loop
-                    if (adjacencyMatrix[static_cast<size_t>(u)][static_cast<size_t>(u)] == 1)
-                        return "0";
-
-                    // Check all adjacent vertices
-                    for (int v = 0; v < numVertices; ++v)
+                    // Check all adjacent vertices (a self-loop fails the same-color check below)
+                    for (size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
                     {
+                        int v = adjacency.target(e);
                         // If there is an edge from u to v and v is not colored
-                        if (adjacencyMatrix[static_cast<size_t>(u)][static_cast<size_t>(v)] && colorArr[static_cast<size_t>(v)] == -1)
+                        if (colorArr[static_cast<size_t>(v)] == -1)
                         {
                             // Assign alternate color to the adjacent vertex of u
                             colorArr[static_cast<size_t>(v)] = 1 - colorArr[static_cast<size_t>(u)];
@@ -173,13 +192,49 @@ namespace ariel
                                 setB.push_back(v);
                         }
                         // If there is an edge from u to v and v is colored with the same color as u
-                        else if (adjacencyMatrix[static_cast<size_t>(u)][static_cast<size_t>(v)] && colorArr[static_cast<size_t>(v)] == colorArr[static_cast<size_t>(u)])
-                            return "0";
+                        else if (colorArr[static_cast<size_t>(v)] == colorArr[static_cast<size_t>(u)])
+                            return false;
                     }
                 }
             }
         }
 
+        return true;
+    }
+
+    std::string AlgorithmsBase::formatPath(const std::vector<int> &path)
+    {
+        if (path.empty())
+        {
+            return "-1";
+        }
+
+        std::string pathStr = std::to_string(path[0]);
+        for (size_t i = 1; i < path.size(); ++i)
+        {
+            pathStr += "->" + std::to_string(path[i]);
+        }
+        return pathStr;
+    }
+
+    std::string AlgorithmsBase::describeCycle(const std::vector<int> &cycle)
+    {
+        if (cycle.empty())
+        {
+            return "0";
+        }
+
+        // Construct the output string for the cycle, closing it at its first vertex
+        std::string cycleStr = "The cycle is: ";
+        for (int vertex : cycle)
+        {
+            cycleStr += std::to_string(vertex) + "->";
+        }
+        return cycleStr + std::to_string(cycle[0]);
+    }
+
+    std::string AlgorithmsBase::formatBipartition(const std::vector<int> &setA, const std::vector<int> &setB)
+    {
         // Construct the output string
         std::string output = "The graph is bipartite: A={";
         for (size_t i = 0; i < setA.size(); ++i)
@@ -199,120 +254,23 @@ namespace ariel
 
         return output;
     }
-    std::string Algorithms::negativeCycle(const Graph &g)
-    {
-        // Get the number of vertices in the graph
-        std::vector<std::vector<int>>::size_type numVertices = static_cast<std::vector<std::vector<int>>::size_type>(g.getVertices());
-
-        // Get the adjacency matrix of the graph
-        const auto &adjacencyMatrix = g.getAdjacencyMatrix();
-
-        // Initialize distance array to store shortest distances from source vertex
-        std::vector<int> distance(numVertices, std::numeric_limits<int>::max());
-        distance[0] = 0; // Assuming source vertex is 0
-
-        // Initialize parent array to store parent vertices in the shortest path tree
-        std::vector<int> parent(numVertices, -1);
 
-        // Relax edges repeatedly
-        bool negativeCycleFound = false;
-        for (std::vector<std::vector<int>>::size_type i = 0; i < numVertices - 1; ++i)
-        {
-            for (std::vector<std::vector<int>>::size_type u = 0; u < numVertices; ++u)
-            {
-                for (std::vector<int>::size_type v = 0; v < numVertices; ++v)
-                {
-                    if (adjacencyMatrix[u][v] != 0)
-                    {
-                        if (distance[u] != std::numeric_limits<int>::max() && distance[u] + adjacencyMatrix[u][v] < distance[v])
-                        {
-                            distance[v] = distance[u] + adjacencyMatrix[u][v];
-                            parent[v] = u;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Check for negative cycles
-        for (std::vector<std::vector<int>>::size_type u = 0; u < numVertices; ++u)
-        {
-            for (std::vector<int>::size_type v = 0; v < numVertices; ++v)
-            {
-                if (adjacencyMatrix[u][v] != 0)
-                {
-                    if (distance[u] != std::numeric_limits<int>::max() && distance[u] + adjacencyMatrix[u][v] < distance[v])
-                    {
-                        // Found a negative cycle, construct and return the cycle
-                        std::vector<int> cycle;
-                        int current = v;
-                        while (current != u)
-                        {
-                            if (current == -1)
-                            {
-                                // Cycle detected, but no cycle formed
-                                return "No negative cycle found.";
-                            }
-                            cycle.push_back(current);
-                            current = static_cast<int>(parent[static_cast<std::vector<int>::size_type>(current)]);
-                        }
-                        cycle.push_back(u);
-                        std::reverse(cycle.begin(), cycle.end());
-
-                        std::string cycleStr;
-                        for (int vertex : cycle)
-                        {
-                            cycleStr += std::to_string(vertex) + "->";
-                        }
-                        // Remove the trailing "->"
-                        cycleStr.pop_back();
-                        cycleStr.pop_back();
-                        return "Negative cycle found: " + cycleStr;
-                    }
-                }
-            }
-        }
-
-        return "No negative cycle found.";
-    }
-
-    bool Algorithms::dfs(const std::vector<std::vector<int>> &adjacencyMatrix, std::vector<bool> &visited, int start)
+    std::string AlgorithmsBase::describeNegativeCycle(const std::vector<int> &cycle)
     {
-        stack<int> s;
-
-        // Push the start vertex to the stack
-        s.push(start);
-
-        // Mark the start vertex as visited
-        visited[static_cast<std::vector<bool>::size_type>(start)] = true;
-
-        // Run DFS
-        while (!s.empty())
+        if (cycle.empty())
         {
-            // Pop a vertex from the stack
-            int v = s.top();
-            s.pop();
-
-            // Check all adjacent vertices of the popped vertex
-            for (std::vector<int>::size_type i = 0; i < adjacencyMatrix[static_cast<std::vector<bool>::size_type>(v)].size(); ++i)
-            {
-                // If an adjacent vertex is not visited, mark it visited and push it to the stack
-                if (adjacencyMatrix[static_cast<std::vector<bool>::size_type>(v)][i] && !visited[i])
-                {
-                    visited[i] = true;
-                    s.push(static_cast<int>(i));
-                }
-            }
+            return "No negative cycle found.";
         }
 
-        // Check if all vertices were visited
-        for (size_t i = 0; i < visited.size(); ++i)
+        std::string cycleStr;
+        for (int vertex : cycle)
         {
-            if (!visited[i])
-                return false;
+            cycleStr += std::to_string(vertex) + "->";
         }
-
-        return true;
+        // Remove the trailing "->"
+        cycleStr.pop_back();
+        cycleStr.pop_back();
+        return "Negative cycle found: " + cycleStr;
     }
 
 }
\ No newline at end of file
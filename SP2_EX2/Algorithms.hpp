@@ -2,25 +2,37 @@
 #ifndef ALGORITHMS_HPP
 #define ALGORITHMS_HPP
 
+#include "BasicAlgorithms.hpp"
 #include "Graph.hpp"
 #include <string>
 
 namespace ariel
 {
 
-    class Algorithms
+    // ariel::Algorithms: the int specialization. The queries are the shared AlgorithmsBase ones, with
+    // the dense vector kernel for negative cycles on full matrices and the whole-graph answers
+    // memoized in the ResultCache.
+    template <>
+    class BasicAlgorithms<int> : private AlgorithmsBase
     {
     public:
+        typedef long long Distance;
+
         static bool isConnected(const Graph &g);
+        static bool isStronglyConnected(const Graph &g);
         static std::string shortestPath(const Graph &g, int start, int end);
-        static std::string isContainsCycle(const Graph &g);
+        static std::string isContainsCycle(const Graph &g, CycleMode mode = CycleMode::Undirected);
+        // Vertices of some cycle in order, the first not repeated at the end; empty if there is none
+        static std::vector<int> findCycle(const Graph &g, CycleMode mode);
         static std::string isBipartite(const Graph &g);
         static std::string negativeCycle(const Graph &g);
 
     private:
-        static bool dfs(const std::vector<std::vector<int>> &adjacencyMatrix, std::vector<bool> &visited, int start);
-        static bool isContainsCycleH(const std::vector<std::vector<int>> &adjacencyMatrix, int vertex, std::vector<bool> &visited, int parent, std::vector<int> &cycle);
+        // Uncached implementation of negativeCycle
+        static std::string computeNegativeCycle(const Graph &g);
     };
+
+    typedef BasicAlgorithms<int> Algorithms;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,284 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "AllPairs.hpp"
+#include "Avx2Ops.hpp"
+#include "CpuFeatures.hpp"
+#include "Graph.hpp"
+#include "MatrixProduct.hpp"
+#include "ShortestPaths.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    const int AllPairsShortestPaths::UNREACHABLE = MatrixProduct::INFINITE_DISTANCE;
+
+    namespace
+    {
+        const int INF = MatrixProduct::INFINITE_DISTANCE;
+
+        // distance[j] = min(distance[j], viaK + fromK[j]) for j < count, recording hop where it improves.
+        // viaK is never INF (callers skip such rows).
+        typedef void (*RowRelax)(int *distance, int *hops, const int *fromK, std::size_t count, int viaK, int hop);
+
+        void relaxRowScalar(int *distance, int *hops, const int *fromK, std::size_t count, int viaK, int hop)
+        {
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                int candidate = distanceAdd(viaK, fromK[j], INF);
+                if (candidate < distance[j])
+                {
+                    distance[j] = candidate;
+                    hops[j] = hop;
+                }
+            }
+        }
+
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 void relaxRowAvx2(int *distance, int *hops, const int *fromK, std::size_t count, int viaK, int hop)
+        {
+            const __m256i infinity = _mm256_set1_epi32(INF);
+            const __m256i via = _mm256_set1_epi32(viaK);
+            const __m256i hopLanes = _mm256_set1_epi32(hop);
+            std::size_t j = 0;
+            for (; j + 8 <= count; j += 8)
+            {
+                __m256i candidate = avx2::distanceAdd(via, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(fromK + j)), infinity);
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(distance + j));
+                __m256i better = _mm256_cmpgt_epi32(current, candidate);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(distance + j), _mm256_blendv_epi8(current, candidate, better));
+                __m256i currentHops = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hops + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(hops + j), _mm256_blendv_epi8(currentHops, hopLanes, better));
+            }
+            relaxRowScalar(distance + j, hops + j, fromK + j, count - j, viaK, hop);
+        }
+#endif
+
+        // One Floyd-Warshall step over tile (rowTile, colTile) for the intermediates of tile kTile
+        void relaxTile(DenseMatrix &distances, DenseMatrix &hops, std::size_t rowTile, std::size_t colTile, std::size_t kTile, RowRelax relax)
+        {
+            const std::size_t tile = static_cast<std::size_t>(AllPairsShortestPaths::TILE);
+            std::size_t n = distances.size();
+            std::size_t rowEnd = std::min(n, (rowTile + 1) * tile);
+            std::size_t colBegin = colTile * tile;
+            std::size_t colCount = std::min(n, colBegin + tile) - colBegin;
+            std::size_t kEnd = std::min(n, (kTile + 1) * tile);
+            for (std::size_t k = kTile * tile; k < kEnd; ++k)
+            {
+                const int *fromK = distances.rowData(k) + colBegin;
+                for (std::size_t i = rowTile * tile; i < rowEnd; ++i)
+                {
+                    int viaK = distances.rowData(i)[k];
+                    if (viaK == INF)
+                    {
+                        continue;
+                    }
+                    relax(distances.rowData(i) + colBegin, hops.rowData(i) + colBegin, fromK, colCount, viaK, hops.rowData(i)[k]);
+                }
+            }
+        }
+
+        // Turns a shortest path tree into one row of the next-hop matrix: hops[v] is the child of the
+        // source on the tree path to v. Each vertex is resolved once, so this is O(V).
+        void treeToHops(const ShortestPathTree &tree, int *hops, std::vector<int> &chain)
+        {
+            std::size_t n = tree.parent.size();
+            hops[tree.source] = tree.source;
+            for (std::size_t v = 0; v < n; ++v)
+            {
+                if (hops[v] != -1 || !tree.reaches(static_cast<int>(v)))
+                {
+                    continue;
+                }
+                chain.clear();
+                int u = static_cast<int>(v);
+                while (hops[u] == -1 && tree.parent[static_cast<std::size_t>(u)] != tree.source)
+                {
+                    chain.push_back(u);
+                    u = tree.parent[static_cast<std::size_t>(u)];
+                }
+                int hop = hops[u] == -1 ? u : hops[u];
+                hops[u] = hop;
+                for (int w : chain)
+                {
+                    hops[w] = hop;
+                }
+            }
+        }
+
+        int clampDistance(Distance d)
+        {
+            return d > INT_MAX ? INT_MAX : (d < INT_MIN ? INT_MIN : static_cast<int>(d));
+        }
+    }
+
+    AllPairsShortestPaths AllPairsShortestPaths::floydWarshall(const Graph &g)
+    {
+        std::size_t n = static_cast<std::size_t>(g.getVertices());
+        const CsrAdjacency &adjacency = g.getCsr();
+        AllPairsShortestPaths result;
+        result.distances = DenseMatrix(n, INF);
+        result.nextHops = DenseMatrix(n, -1);
+        for (int u = 0; u < g.getVertices(); ++u)
+        {
+            std::size_t row = static_cast<std::size_t>(u);
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                std::size_t v = static_cast<std::size_t>(adjacency.target(e));
+                result.distances[row][v] = adjacency.weight(e);
+                result.nextHops[row][v] = adjacency.target(e);
+            }
+            if (result.distances[row][row] >= 0)
+            {
+                result.distances[row][row] = 0;
+                result.nextHops[row][row] = u;
+            }
+        }
+
+        RowRelax relax = relaxRowScalar;
+#if ARIEL_X86_DISPATCH
+        if (CpuFeatures::hasAvx2())
+        {
+            relax = relaxRowAvx2;
+        }
+#endif
+
+        DenseMatrix &distances = result.distances;
+        DenseMatrix &hops = result.nextHops;
+        ThreadPool &pool = ThreadPool::shared();
+        std::size_t tiles = (n + static_cast<std::size_t>(TILE) - 1) / static_cast<std::size_t>(TILE);
+        for (std::size_t k = 0; k < tiles; ++k)
+        {
+            // Phase 1: the diagonal tile depends only on itself
+            relaxTile(distances, hops, k, k, k, relax);
+
+            // Phase 2: tiles in row k and column k depend on themselves and the diagonal tile
+            pool.parallelFor(0, 2 * tiles, 1, [&](std::size_t first, std::size_t last)
+                             {
+                                 for (std::size_t t = first; t < last; ++t)
+                                 {
+                                     std::size_t other = t / 2;
+                                     if (other == k)
+                                     {
+                                         continue;
+                                     }
+                                     if (t % 2 == 0)
+                                     {
+                                         relaxTile(distances, hops, k, other, k, relax);
+                                     }
+                                     else
+                                     {
+                                         relaxTile(distances, hops, other, k, k, relax);
+                                     }
+                                 }
+                             });
+
+            // Phase 3: every other tile reads only row k and column k, which are now final
+            pool.parallelFor(0, tiles, 1, [&](std::size_t first, std::size_t last)
+                             {
+                                 for (std::size_t i = first; i < last; ++i)
+                                 {
+                                     if (i == k)
+                                     {
+                                         continue;
+                                     }
+                                     for (std::size_t j = 0; j < tiles; ++j)
+                                     {
+                                         if (j != k)
+                                         {
+                                             relaxTile(distances, hops, i, j, k, relax);
+                                         }
+                                     }
+                                 }
+                             });
+        }
+
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            if (distances[v][v] < 0)
+            {
+                result.negativeCycle = true;
+                break;
+            }
+        }
+        return result;
+    }
+
+    AllPairsShortestPaths AllPairsShortestPaths::johnson(const Graph &g)
+    {
+        std::size_t n = static_cast<std::size_t>(g.getVertices());
+        const CsrAdjacency &adjacency = g.getCsr();
+        AllPairsShortestPaths result;
+        result.distances = DenseMatrix(n, INF);
+        result.nextHops = DenseMatrix(n, -1);
+
+        std::vector<Distance> potential;
+        if (!ShortestPaths::potentials(adjacency, potential))
+        {
+            result.negativeCycle = true;
+            return result;
+        }
+
+        ThreadPool::shared().parallelFor(0, n, 1, [&](std::size_t first, std::size_t last)
+                                         {
+                                             std::vector<int> chain;
+                                             for (std::size_t s = first; s < last; ++s)
+                                             {
+                                                 ShortestPathTree tree = ShortestPaths::dijkstra(adjacency, static_cast<int>(s), potential);
+                                                 int *row = result.distances.rowData(s);
+                                                 for (std::size_t v = 0; v < n; ++v)
+                                                 {
+                                                     if (tree.distance[v] != ShortestPathTree::UNREACHABLE)
+                                                     {
+                                                         row[v] = clampDistance(tree.distance[v]);
+                                                     }
+                                                 }
+                                                 treeToHops(tree, result.nextHops.rowData(s), chain);
+                                             }
+                                         });
+        return result;
+    }
+
+    void AllPairsShortestPaths::checkVertex(int v) const
+    {
+        if (v < 0 || v >= getVertices())
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+    }
+
+    int AllPairsShortestPaths::distance(int from, int to) const
+    {
+        checkVertex(from);
+        checkVertex(to);
+        return distances[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)];
+    }
+
+    int AllPairsShortestPaths::nextHop(int from, int to) const
+    {
+        checkVertex(from);
+        checkVertex(to);
+        return nextHops[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)];
+    }
+
+    std::vector<int> AllPairsShortestPaths::path(int from, int to) const
+    {
+        checkVertex(from);
+        checkVertex(to);
+        std::vector<int> vertices;
+        if (negativeCycle || nextHop(from, to) == -1)
+        {
+            return vertices;
+        }
+        vertices.push_back(from);
+        for (int u = from; u != to;)
+        {
+            u = nextHops[static_cast<std::size_t>(u)][static_cast<std::size_t>(to)];
+            vertices.push_back(u);
+        }
+        return vertices;
+    }
+
+}
@@ -0,0 +1,58 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef ALL_PAIRS_HPP
+#define ALL_PAIRS_HPP
+
+#include "DenseMatrix.hpp"
+#include "GraphFwd.hpp"
+#include <vector>
+
+namespace ariel
+{
+
+    // All-pairs shortest distances together with a next-hop matrix: nextHop(u, v) is the vertex after u
+    // on a shortest u -> v path, so any path is read off in O(length).
+    class AllPairsShortestPaths
+    {
+    public:
+        static const int UNREACHABLE;
+        static const int TILE = 64;
+
+        // Blocked Floyd-Warshall. For every diagonal tile: close the tile itself, then the tiles in its
+        // row and column, then all remaining tiles in parallel. The inner loop is AVX2 when available.
+        static AllPairsShortestPaths floydWarshall(const Graph &g);
+
+        // Johnson's algorithm for sparse graphs: Bellman-Ford from a virtual source finds potentials that
+        // make every weight non-negative (or a negative cycle anywhere in the graph), then one Dijkstra
+        // per source runs in parallel on the sparse adjacency. If there is a negative cycle every entry
+        // is left UNREACHABLE.
+        static AllPairsShortestPaths johnson(const Graph &g);
+
+        int getVertices() const { return static_cast<int>(distances.size()); }
+
+        // Some vertex lies on a negative cycle; distances and paths are then not meaningful
+        bool hasNegativeCycle() const { return negativeCycle; }
+
+        // UNREACHABLE if there is no path. Sums saturate at INT_MAX / INT_MIN.
+        int distance(int from, int to) const;
+        // -1 if there is no path; from itself when from == to
+        int nextHop(int from, int to) const;
+
+        // Vertices from `from` to `to`, or an empty vector if there is no path or a negative cycle
+        std::vector<int> path(int from, int to) const;
+
+        const DenseMatrix &getDistances() const { return distances; }
+        const DenseMatrix &getNextHops() const { return nextHops; }
+
+    private:
+        AllPairsShortestPaths() : negativeCycle(false) {}
+
+        void checkVertex(int v) const;
+
+        DenseMatrix distances;
+        DenseMatrix nextHops;
+        bool negativeCycle;
+    };
+
+}
+
+#endif
@@ -0,0 +1,54 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef AVX2_OPS_HPP
+#define AVX2_OPS_HPP
+
+#include "CpuFeatures.hpp"
+#include <climits>
+
+#if ARIEL_X86_DISPATCH
+#include <immintrin.h>
+
+namespace ariel
+{
+
+    // Small AVX2 building blocks shared by the vector kernels; only call them from AVX2-targeted code.
+    namespace avx2
+    {
+        // Lane-wise a + b clamped to [INT_MIN, INT_MAX] instead of wrapping
+        ARIEL_TARGET_AVX2 inline __m256i saturatingAdd(__m256i a, __m256i b)
+        {
+            __m256i sum = _mm256_add_epi32(a, b);
+            // Signed overflow iff both operands differ in sign from the sum; clamp towards a's sign
+            __m256i overflow = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum)), 31);
+            __m256i clamp = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT_MAX));
+            return _mm256_blendv_epi8(sum, clamp, overflow);
+        }
+
+        // Saturating a + b that stays `infinity` whenever either operand is `infinity`
+        ARIEL_TARGET_AVX2 inline __m256i distanceAdd(__m256i a, __m256i b, __m256i infinity)
+        {
+            __m256i missing = _mm256_or_si256(_mm256_cmpeq_epi32(a, infinity), _mm256_cmpeq_epi32(b, infinity));
+            return _mm256_blendv_epi8(saturatingAdd(a, b), infinity, missing);
+        }
+    }
+
+}
+#endif
+
+namespace ariel
+{
+
+    // Scalar counterpart of avx2::distanceAdd
+    inline int distanceAdd(int a, int b, int infinity)
+    {
+        if (a == infinity || b == infinity)
+        {
+            return infinity;
+        }
+        long long sum = static_cast<long long>(a) + b;
+        return sum > INT_MAX ? INT_MAX : (sum < INT_MIN ? INT_MIN : static_cast<int>(sum));
+    }
+
+}
+
+#endif
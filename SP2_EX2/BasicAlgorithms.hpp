@@ -0,0 +1,119 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef BASIC_ALGORITHMS_HPP
+#define BASIC_ALGORITHMS_HPP
+
+#include "BasicGraph.hpp"
+#include "ParallelBfs.hpp"
+#include "ShortestPaths.hpp"
+#include "StronglyConnected.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ariel
+{
+
+    // Directed: a cycle follows edge directions, so u -> v -> u counts.
+    // Undirected: every edge is taken both ways and u -> v, v -> u is a single edge, not a cycle.
+    enum class CycleMode
+    {
+        Undirected,
+        Directed
+    };
+
+    // The traversals and answer formats shared by every BasicAlgorithms. Each query runs on the graph's
+    // CSR view (and its bit rows once BitAdjacency::isWorthwhile) through the same BFS, Tarjan,
+    // Dijkstra / Bellman-Ford and SPFA code whatever the weight type, so a BasicGraph<W> gets the
+    // same answers as the int graph with the same edges.
+    class AlgorithmsBase
+    {
+    protected:
+        template <typename G>
+        static bool connected(const G &g)
+        {
+            return g.getVertices() == 0 || ParallelBfs::reachableCount(g, 0) == static_cast<std::size_t>(g.getVertices());
+        }
+
+        // One O(V + E) Tarjan pass: every vertex must land in the same component
+        template <typename G>
+        static bool stronglyConnected(const G &g)
+        {
+            std::vector<int> component;
+            return StronglyConnected::components(g.getCsr(), component) <= 1;
+        }
+
+        // Dijkstra when all weights are non-negative, Bellman-Ford otherwise; "-1" if end is
+        // unreachable or a negative cycle reachable from start leaves the path undefined
+        template <typename G>
+        static std::string shortestPathIn(const G &g, int start, int end)
+        {
+            if (end < 0 || end >= g.getVertices())
+            {
+                throw std::invalid_argument("Vertex out of range.");
+            }
+            return formatPath(ShortestPaths::compute(g, start).pathTo(end));
+        }
+
+        template <typename G>
+        static std::vector<int> cycleIn(const G &g, CycleMode mode)
+        {
+            // In undirected mode the in-edges are walked as well
+            return findCycle(g.getCsr(), mode == CycleMode::Undirected ? &g.getReverseCsr() : nullptr);
+        }
+
+        template <typename G>
+        static std::string bipartitionOf(const G &g)
+        {
+            std::vector<int> setA, setB;
+            bool bipartite = BitAdjacency::isWorthwhile(g.getCsr()) ? g.getBitAdjacency().twoColor(setA, setB)
+                                                                     : twoColor(g.getCsr(), setA, setB);
+            return bipartite ? formatBipartition(setA, setB) : "0";
+        }
+
+        // DFS over the sorted rows, merged with the in-edge rows of reverse if given. Returns the
+        // vertices of the first cycle found, or an empty vector.
+        static std::vector<int> findCycle(const CsrStructure &adjacency, const CsrStructure *reverse);
+
+        // BFS 2-coloring over out-edges; false on an edge between two vertices of the same color
+        static bool twoColor(const CsrStructure &adjacency, std::vector<int> &setA, std::vector<int> &setB);
+
+        static std::string formatPath(const std::vector<int> &path);
+        static std::string describeCycle(const std::vector<int> &cycle);
+        static std::string formatBipartition(const std::vector<int> &setA, const std::vector<int> &setB);
+        static std::string describeNegativeCycle(const std::vector<int> &cycle);
+    };
+
+    // The graph algorithms for any weight type, on AlgorithmsBase. ariel::Algorithms, the int
+    // specialization (Algorithms.hpp), adds the dense vector kernels and memoizes its answers in the
+    // ResultCache. Path lengths are summed in WeightTraits<W>::Sum.
+    template <typename W>
+    class BasicAlgorithms : private AlgorithmsBase
+    {
+    public:
+        typedef typename WeightTraits<W>::Sum Distance;
+
+        static bool isConnected(const BasicGraph<W> &g) { return connected(g); }
+        static bool isStronglyConnected(const BasicGraph<W> &g) { return stronglyConnected(g); }
+        static std::string shortestPath(const BasicGraph<W> &g, int start, int end) { return shortestPathIn(g, start, end); }
+
+        static std::string isContainsCycle(const BasicGraph<W> &g, CycleMode mode = CycleMode::Undirected)
+        {
+            return describeCycle(cycleIn(g, mode));
+        }
+
+        // Vertices of some cycle in order, the first not repeated at the end; empty if there is none
+        static std::vector<int> findCycle(const BasicGraph<W> &g, CycleMode mode) { return cycleIn(g, mode); }
+
+        static std::string isBipartite(const BasicGraph<W> &g) { return bipartitionOf(g); }
+
+        // SPFA from a virtual source with a zero edge to every vertex, so a negative cycle is found
+        // anywhere in the graph
+        static std::string negativeCycle(const BasicGraph<W> &g)
+        {
+            return describeNegativeCycle(ShortestPaths::findNegativeCycle(g.getCsr()));
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,373 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef BASIC_GRAPH_HPP
+#define BASIC_GRAPH_HPP
+
+#include "BitAdjacency.hpp"
+#include "CsrAdjacency.hpp"
+#include "GraphFwd.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ariel
+{
+
+    // Next value of the one counter behind every graph's version, whatever its weight type
+    std::uint64_t nextGraphVersion();
+
+    // Sums of weights (totals, path lengths) are kept in a wider type, so that 8- and 16-bit weights
+    // do not overflow along a path. For int this is ariel::Distance (ShortestPaths.hpp).
+    template <typename W>
+    struct WeightTraits
+    {
+        typedef typename std::conditional<std::is_floating_point<W>::value, double, std::int64_t>::type Sum;
+    };
+
+    // The CSR and bitset views of one graph state, each built once on first use. A graph and its
+    // unmodified copies share one set, and every mutation starts a new, empty one. The once flags make
+    // building safe when several threads query the same graph at once.
+    template <typename W>
+    class AdjacencyViews
+    {
+    public:
+        // build() makes the forward CSR; it runs only if the CSR is not there yet
+        template <typename Build>
+        const BasicCsrAdjacency<W> &csr(Build build)
+        {
+            std::call_once(csrBuilt, [this, &build]()
+                           { forward.reset(new BasicCsrAdjacency<W>(build())); });
+            return *forward;
+        }
+
+        const BasicCsrAdjacency<W> &reverseCsr(const BasicCsrAdjacency<W> &csr)
+        {
+            std::call_once(reverseBuilt, [this, &csr]()
+                           { reverse.reset(new BasicCsrAdjacency<W>(csr.transpose())); });
+            return *reverse;
+        }
+
+        const BitAdjacency &bitAdjacency(const CsrStructure &csr)
+        {
+            std::call_once(bitsBuilt, [this, &csr]()
+                           { bits.reset(new BitAdjacency(csr)); });
+            return *bits;
+        }
+
+    private:
+        std::once_flag csrBuilt;
+        std::once_flag reverseBuilt;
+        std::once_flag bitsBuilt;
+        std::unique_ptr<const BasicCsrAdjacency<W>> forward;
+        std::unique_ptr<const BasicCsrAdjacency<W>> reverse;
+        std::unique_ptr<const BitAdjacency> bits;
+    };
+
+    // Adjacency-matrix graph over weights of type W (int8_t, int16_t, int64_t, float, double, ...).
+    // A zero weight means "no edge". The matrix is one contiguous n * n array, so narrow types move
+    // proportionally less memory and the element-wise loops vectorize; arithmetic on narrow types
+    // wraps to W like int arithmetic does in ariel::Graph. The CSR and bitset views are built on first
+    // use, as for ariel::Graph, so BasicAlgorithms<W> runs on the same CSR, BFS and shortest-path
+    // kernels. ariel::Graph, the int graph, is a specialization (Graph.hpp) that adds the dense
+    // vector kernels.
+    template <typename W>
+    class BasicGraph
+    {
+    public:
+        typedef W Weight;
+        typedef typename WeightTraits<W>::Sum WeightSum;
+
+        BasicGraph() : vertices(0), version(nextGraphVersion()), views(std::make_shared<AdjacencyViews<W>>()), edgeCount(0), totalWeight(0) {}
+
+        void loadGraph(const std::vector<std::vector<W>> &graph)
+        {
+            if (!isValidGraph(graph))
+            {
+                throw std::invalid_argument("Invalid graph: The graph is not a square matrix.");
+            }
+            std::size_t n = graph.size();
+            vertices = static_cast<int>(n);
+            cells.resize(n * n);
+            rewrite([&graph, n](std::size_t k)
+                    { return graph[k / n][k % n]; });
+        }
+
+        bool isValidGraph(const std::vector<std::vector<W>> &graph) const
+        {
+            if (graph.empty())
+            {
+                return false;
+            }
+            for (const std::vector<W> &row : graph)
+            {
+                if (row.size() != graph.size())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        int getVertices() const { return vertices; }
+        bool isDense() const { return true; }
+        // Row u of the matrix: weights of u -> v for every v. Unchecked.
+        const W *row(int u) const { return cells.data() + static_cast<std::size_t>(u) * size(); }
+
+        const BasicCsrAdjacency<W> &getCsr() const
+        {
+            const std::vector<W> &matrix = cells;
+            std::size_t n = size();
+            return views->csr([&matrix, n]()
+                              { return BasicCsrAdjacency<W>::fromCells(matrix.data(), n, n); });
+        }
+        const BasicCsrAdjacency<W> &getReverseCsr() const { return views->reverseCsr(getCsr()); }
+        const BitAdjacency &getBitAdjacency() const { return views->bitAdjacency(getCsr()); }
+
+        void printGraph() const { std::cout << toString() << std::endl; }
+        std::string toString() const
+        {
+            std::ostringstream oss;
+            for (int u = 0; u < vertices; ++u)
+            {
+                oss << "[";
+                writeRow(oss, u);
+                oss << "]";
+                if (u != vertices - 1)
+                {
+                    oss << "\n";
+                }
+            }
+            return oss.str();
+        }
+
+        std::uint64_t getVersion() const { return version; }
+        std::size_t getEdgeCount() const { return edgeCount; }
+        int getOutDegree(int u) const { return outDegrees[checkedVertex(u)]; }
+        int getInDegree(int v) const { return inDegrees[checkedVertex(v)]; }
+        WeightSum getTotalWeight() const { return totalWeight; }
+
+        BasicGraph &operator+=(const BasicGraph &other)
+        {
+            requireSameSize(other, "add");
+            rewrite([this, &other](std::size_t k)
+                    { return static_cast<W>(cells[k] + other.cells[k]); });
+            return *this;
+        }
+
+        BasicGraph &operator-=(const BasicGraph &other)
+        {
+            requireSameSize(other, "subtract");
+            rewrite([this, &other](std::size_t k)
+                    { return static_cast<W>(cells[k] - other.cells[k]); });
+            return *this;
+        }
+
+        BasicGraph &operator*=(W scalar)
+        {
+            rewrite([this, scalar](std::size_t k)
+                    { return static_cast<W>(cells[k] * scalar); });
+            return *this;
+        }
+
+        BasicGraph &operator/=(W scalar)
+        {
+            if (scalar == W())
+            {
+                throw std::invalid_argument("Division by zero is not allowed.");
+            }
+            rewrite([this, scalar](std::size_t k)
+                    { return static_cast<W>(cells[k] / scalar); });
+            return *this;
+        }
+
+        BasicGraph operator+(const BasicGraph &other) const { return BasicGraph(*this) += other; }
+        BasicGraph operator-(const BasicGraph &other) const { return BasicGraph(*this) -= other; }
+        BasicGraph operator*(W scalar) const { return BasicGraph(*this) *= scalar; }
+        BasicGraph operator/(W scalar) const { return BasicGraph(*this) /= scalar; }
+        BasicGraph operator+() const { return *this; }
+        BasicGraph operator-() const { return BasicGraph(*this) *= static_cast<W>(-1); }
+
+        // Matrix product, accumulated in W
+        BasicGraph operator*(const BasicGraph &other) const
+        {
+            requireSameSize(other, "multiply");
+            std::size_t n = size();
+            std::vector<W> product(n * n, W());
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                W *out = product.data() + i * n;
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    W a = cells[i * n + k];
+                    if (a == W())
+                    {
+                        continue;
+                    }
+                    const W *b = other.cells.data() + k * n;
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        out[j] = static_cast<W>(out[j] + a * b[j]);
+                    }
+                }
+            }
+            BasicGraph result;
+            result.vertices = vertices;
+            result.cells.resize(n * n);
+            result.rewrite([&product](std::size_t k)
+                           { return product[k]; });
+            return result;
+        }
+
+        BasicGraph &operator++()
+        {
+            rewrite([this](std::size_t k)
+                    { return static_cast<W>(cells[k] + 1); });
+            return *this;
+        }
+
+        BasicGraph &operator--()
+        {
+            rewrite([this](std::size_t k)
+                    { return static_cast<W>(cells[k] - 1); });
+            return *this;
+        }
+
+        BasicGraph operator++(int)
+        {
+            BasicGraph temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        BasicGraph operator--(int)
+        {
+            BasicGraph temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        bool operator==(const BasicGraph &other) const
+        {
+            return vertices == other.vertices && edgeCount == other.edgeCount && cells == other.cells;
+        }
+
+        bool operator!=(const BasicGraph &other) const { return !(*this == other); }
+
+        // Same rule as ariel::Graph: the first cell, in row-major order, that is an edge in only one
+        // graph decides; with the same edges the heavier graph is greater.
+        bool operator>(const BasicGraph &other) const
+        {
+            requireSameSize(other, "compare");
+            if (edgeCount == 0 || other.edgeCount == 0)
+            {
+                return edgeCount != 0;
+            }
+            for (std::size_t k = 0; k < cells.size(); ++k)
+            {
+                bool here = cells[k] != W(), there = other.cells[k] != W();
+                if (here != there)
+                {
+                    return here;
+                }
+            }
+            return totalWeight > other.totalWeight;
+        }
+
+        bool operator<(const BasicGraph &other) const { return other > *this; }
+        bool operator>=(const BasicGraph &other) const { return !(*this < other); }
+        bool operator<=(const BasicGraph &other) const { return !(*this > other); }
+
+        friend std::ostream &operator<<(std::ostream &os, const BasicGraph &g)
+        {
+            for (int u = 0; u < g.vertices; ++u)
+            {
+                os << "[";
+                g.writeRow(os, u);
+                os << "]\n";
+            }
+            return os;
+        }
+
+    private:
+        std::size_t size() const { return static_cast<std::size_t>(vertices); }
+
+        std::size_t checkedVertex(int u) const
+        {
+            if (u < 0 || u >= vertices)
+            {
+                throw std::invalid_argument("Vertex out of range.");
+            }
+            return static_cast<std::size_t>(u);
+        }
+
+        void requireSameSize(const BasicGraph &other, const char *operation) const
+        {
+            if (vertices != other.vertices)
+            {
+                throw std::invalid_argument(std::string("Graphs must be of the same size to ") + operation + ".");
+            }
+        }
+
+        // Prints weights as numbers, also when W is a character type
+        void writeRow(std::ostream &os, int u) const
+        {
+            const W *weights = row(u);
+            for (std::size_t v = 0; v < size(); ++v)
+            {
+                os << +weights[v];
+                if (v + 1 < size())
+                {
+                    os << ", ";
+                }
+            }
+        }
+
+        // Sets cell k to value(k) for every k, recounting the statistics in the same pass. value(k)
+        // may read cell k itself. Every mutation goes through here and gets a new version.
+        template <typename F>
+        void rewrite(F value)
+        {
+            std::size_t n = size();
+            edgeCount = 0;
+            totalWeight = 0;
+            outDegrees.assign(n, 0);
+            inDegrees.assign(n, 0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    W weight = value(i * n + j);
+                    cells[i * n + j] = weight;
+                    totalWeight += weight;
+                    if (weight != W())
+                    {
+                        ++outDegrees[i];
+                        ++inDegrees[j];
+                        ++edgeCount;
+                    }
+                }
+            }
+            version = nextGraphVersion();
+            views = std::make_shared<AdjacencyViews<W>>();
+        }
+
+        std::vector<W> cells; // row-major, n * n
+        int vertices;
+        std::uint64_t version;
+        std::shared_ptr<AdjacencyViews<W>> views;
+
+        std::size_t edgeCount;
+        std::vector<int> outDegrees;
+        std::vector<int> inDegrees;
+        WeightSum totalWeight;
+    };
+
+}
+
+#endif
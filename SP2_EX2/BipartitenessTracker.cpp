@@ -0,0 +1,127 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "BipartitenessTracker.hpp"
+#include <stdexcept>
+
+namespace ariel
+{
+
+    BipartitenessTracker::BipartitenessTracker(int numVertices) : conflict(-1, -1)
+    {
+        if (numVertices < 0)
+        {
+            throw std::invalid_argument("Number of vertices must be non-negative.");
+        }
+        std::size_t n = static_cast<std::size_t>(numVertices);
+        parent.resize(n);
+        rank.assign(n, 0);
+        parity.assign(n, 0);
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            parent[v] = static_cast<int>(v);
+        }
+    }
+
+    BipartitenessTracker::BipartitenessTracker(const Graph &g) : BipartitenessTracker(g.getVertices())
+    {
+        const CsrAdjacency &adjacency = g.getCsr();
+        for (int u = 0; u < g.getVertices(); ++u)
+        {
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                addEdge(u, adjacency.target(e));
+            }
+        }
+    }
+
+    int BipartitenessTracker::find(int v, unsigned char &parityToRoot)
+    {
+        if (v < 0 || static_cast<std::size_t>(v) >= parent.size())
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+        path.clear();
+        int root = v;
+        while (parent[static_cast<std::size_t>(root)] != root)
+        {
+            path.push_back(root);
+            root = parent[static_cast<std::size_t>(root)];
+        }
+        // Compress from the top down, so each vertex's parent already holds its parity to the root
+        for (std::size_t i = path.size(); i > 0; --i)
+        {
+            std::size_t x = static_cast<std::size_t>(path[i - 1]);
+            std::size_t p = static_cast<std::size_t>(parent[x]);
+            if (static_cast<int>(p) != root)
+            {
+                parity[x] ^= parity[p];
+                parent[x] = root;
+            }
+        }
+        parityToRoot = parity[static_cast<std::size_t>(v)];
+        if (v == root)
+        {
+            parityToRoot = 0;
+        }
+        return root;
+    }
+
+    bool BipartitenessTracker::addEdge(int u, int v)
+    {
+        unsigned char pu, pv;
+        std::size_t ru = static_cast<std::size_t>(find(u, pu));
+        std::size_t rv = static_cast<std::size_t>(find(v, pv));
+        if (ru == rv)
+        {
+            // Same side already: u -> v closes an odd cycle
+            if (pu == pv && isBipartite())
+            {
+                conflict = std::make_pair(u, v);
+            }
+            return isBipartite();
+        }
+        // u and v must end up on opposite sides
+        if (rank[ru] < rank[rv])
+        {
+            std::swap(ru, rv);
+        }
+        parent[rv] = static_cast<int>(ru);
+        parity[rv] = static_cast<unsigned char>(pu ^ pv ^ 1);
+        if (rank[ru] == rank[rv])
+        {
+            ++rank[ru];
+        }
+        return isBipartite();
+    }
+
+    bool BipartitenessTracker::addEdges(const std::vector<Edge> &edges)
+    {
+        for (const Edge &edge : edges)
+        {
+            addEdge(edge.from, edge.to);
+        }
+        return isBipartite();
+    }
+
+    void BipartitenessTracker::partition(std::vector<int> &first, std::vector<int> &second)
+    {
+        if (!isBipartite())
+        {
+            throw std::logic_error("The graph is not bipartite.");
+        }
+        first.clear();
+        second.clear();
+        // Side of each root that the component's lowest vertex is on; 2 = not seen yet
+        std::vector<unsigned char> flip(parent.size(), 2);
+        for (int v = 0; v < getVertices(); ++v)
+        {
+            unsigned char side;
+            std::size_t root = static_cast<std::size_t>(find(v, side));
+            if (flip[root] == 2)
+            {
+                flip[root] = side;
+            }
+            (side == flip[root] ? first : second).push_back(v);
+        }
+    }
+
+}
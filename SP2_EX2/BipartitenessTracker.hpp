@@ -0,0 +1,49 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef BIPARTITENESS_TRACKER_HPP
+#define BIPARTITENESS_TRACKER_HPP
+
+#include "Graph.hpp"
+#include <utility>
+#include <vector>
+
+namespace ariel
+{
+
+    // Online bipartiteness check as edges stream in: a union-find whose every vertex stores the parity
+    // of its path to its parent, i.e. whether it is on the same side as its parent. An edge inside one
+    // set whose ends have equal parity closes an odd cycle. Edge directions are ignored, as in
+    // Algorithms::isBipartite. Near O(1) per edge.
+    class BipartitenessTracker
+    {
+    public:
+        explicit BipartitenessTracker(int numVertices);
+        // Starts from the edges g already has
+        explicit BipartitenessTracker(const Graph &g);
+
+        // Returns whether the graph is still bipartite after this edge
+        bool addEdge(int u, int v);
+        bool addEdges(const std::vector<Edge> &edges);
+
+        int getVertices() const { return static_cast<int>(parent.size()); }
+        bool isBipartite() const { return conflict.first == -1; }
+        // The first edge that closed an odd cycle, or (-1, -1) while the graph is bipartite
+        std::pair<int, int> getFirstConflict() const { return conflict; }
+
+        // Both sides of a 2-coloring, each in increasing vertex order. In every component the lowest
+        // vertex is on the first side. Throws if the graph is not bipartite.
+        void partition(std::vector<int> &first, std::vector<int> &second);
+
+    private:
+        // Root of v's set; parityToRoot receives whether v is on the other side from the root
+        int find(int v, unsigned char &parityToRoot);
+
+        std::vector<int> parent;
+        std::vector<unsigned char> rank;
+        std::vector<unsigned char> parity; // relative to the parent
+        std::vector<int> path;             // scratch for find
+        std::pair<int, int> conflict;
+    };
+
+}
+
+#endif
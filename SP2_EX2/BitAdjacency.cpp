@@ -0,0 +1,177 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "BitAdjacency.hpp"
+#include <stack>
+
+namespace ariel
+{
+
+    namespace
+    {
+        const std::size_t WORD_BITS = 64;
+
+        // Calls visit(v) for every bit v of newBits, lowest first, where the word starts at vertex base
+        template <typename Visit>
+        void forEachBit(std::uint64_t newBits, std::size_t base, Visit visit)
+        {
+            while (newBits != 0)
+            {
+                std::size_t bit = static_cast<std::size_t>(__builtin_ctzll(newBits));
+                visit(static_cast<int>(base + bit));
+                newBits &= newBits - 1;
+            }
+        }
+    }
+
+    BitAdjacency::BitAdjacency() : wordsPerRow(0), vertices(0) {}
+
+    BitAdjacency::BitAdjacency(const CsrStructure &adjacency) : wordsPerRow(0), vertices(adjacency.getVertices())
+    {
+        std::size_t n = static_cast<std::size_t>(vertices);
+        wordsPerRow = (n + WORD_BITS - 1) / WORD_BITS;
+        bits.assign(n * wordsPerRow, 0);
+        for (int u = 0; u < vertices; ++u)
+        {
+            std::uint64_t *words = bits.data() + static_cast<std::size_t>(u) * wordsPerRow;
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                std::size_t v = static_cast<std::size_t>(adjacency.target(e));
+                words[v / WORD_BITS] |= std::uint64_t(1) << (v % WORD_BITS);
+            }
+        }
+    }
+
+    bool BitAdjacency::hasEdge(int u, int v) const
+    {
+        std::size_t sv = static_cast<std::size_t>(v);
+        return (row(u)[sv / WORD_BITS] >> (sv % WORD_BITS)) & 1;
+    }
+
+    bool BitAdjacency::test(const std::vector<std::uint64_t> &set, int v)
+    {
+        std::size_t sv = static_cast<std::size_t>(v);
+        return (set[sv / WORD_BITS] >> (sv % WORD_BITS)) & 1;
+    }
+
+    void BitAdjacency::set(std::vector<std::uint64_t> &set, int v)
+    {
+        std::size_t sv = static_cast<std::size_t>(v);
+        set[sv / WORD_BITS] |= std::uint64_t(1) << (sv % WORD_BITS);
+    }
+
+    std::size_t BitAdjacency::count(const std::vector<std::uint64_t> &set)
+    {
+        std::size_t total = 0;
+        for (std::uint64_t word : set)
+        {
+            total += static_cast<std::size_t>(__builtin_popcountll(word));
+        }
+        return total;
+    }
+
+    std::vector<int> BitAdjacency::bfs(int start, std::vector<std::uint64_t> &visited) const
+    {
+        std::vector<int> order;
+        if (test(visited, start))
+        {
+            return order;
+        }
+        set(visited, start);
+        order.push_back(start);
+
+        // The order vector doubles as the BFS queue
+        for (std::size_t head = 0; head < order.size(); ++head)
+        {
+            const std::uint64_t *words = row(order[head]);
+            for (std::size_t w = 0; w < wordsPerRow; ++w)
+            {
+                std::uint64_t newBits = words[w] & ~visited[w];
+                visited[w] |= newBits;
+                forEachBit(newBits, w * WORD_BITS, [&order](int v) { order.push_back(v); });
+            }
+        }
+        return order;
+    }
+
+    std::vector<int> BitAdjacency::dfs(int start, std::vector<std::uint64_t> &visited) const
+    {
+        std::vector<int> order;
+        if (test(visited, start))
+        {
+            return order;
+        }
+        std::stack<int> s;
+        set(visited, start);
+        s.push(start);
+
+        while (!s.empty())
+        {
+            int u = s.top();
+            s.pop();
+            order.push_back(u);
+            const std::uint64_t *words = row(u);
+            for (std::size_t w = 0; w < wordsPerRow; ++w)
+            {
+                std::uint64_t newBits = words[w] & ~visited[w];
+                visited[w] |= newBits;
+                forEachBit(newBits, w * WORD_BITS, [&s](int v) { s.push(v); });
+            }
+        }
+        return order;
+    }
+
+    bool BitAdjacency::twoColor(std::vector<int> &first, std::vector<int> &second) const
+    {
+        std::vector<std::uint64_t> firstSet = emptySet();
+        std::vector<std::uint64_t> secondSet = emptySet();
+        std::vector<int> queue;
+
+        for (int root = 0; root < vertices; ++root)
+        {
+            if (test(firstSet, root) || test(secondSet, root))
+            {
+                continue;
+            }
+            set(firstSet, root);
+            first.push_back(root);
+            queue.assign(1, root);
+
+            for (std::size_t head = 0; head < queue.size(); ++head)
+            {
+                int u = queue[head];
+                bool inFirst = test(firstSet, u);
+                const std::vector<std::uint64_t> &same = inFirst ? firstSet : secondSet;
+                std::vector<std::uint64_t> &opposite = inFirst ? secondSet : firstSet;
+                std::vector<int> &oppositeList = inFirst ? second : first;
+                const std::uint64_t *words = row(u);
+                for (std::size_t w = 0; w < wordsPerRow; ++w)
+                {
+                    // An edge into u's own color (including a self-loop) breaks the 2-coloring
+                    if ((words[w] & same[w]) != 0)
+                    {
+                        return false;
+                    }
+                    std::uint64_t newBits = words[w] & ~(firstSet[w] | secondSet[w]);
+                    opposite[w] |= newBits;
+                    forEachBit(newBits, w * WORD_BITS, [&queue, &oppositeList](int v)
+                               {
+                                   queue.push_back(v);
+                                   oppositeList.push_back(v);
+                               });
+                }
+            }
+        }
+        return true;
+    }
+
+    bool BitAdjacency::isWorthwhile(const CsrStructure &adjacency, int minVertices)
+    {
+        std::size_t n = static_cast<std::size_t>(adjacency.getVertices());
+        if (adjacency.getVertices() < minVertices)
+        {
+            return false;
+        }
+        std::size_t words = (n + WORD_BITS - 1) / WORD_BITS;
+        return adjacency.getEdgeCount() >= n * words;
+    }
+
+}
@@ -0,0 +1,54 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef BIT_ADJACENCY_HPP
+#define BIT_ADJACENCY_HPP
+
+#include "CsrAdjacency.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ariel
+{
+
+    // Unweighted adjacency packed 64 vertices per word: bit v of row u is set iff u -> v is an edge.
+    // Traversals expand a vertex with one AND-NOT per word against the visited set instead of one
+    // comparison per matrix cell.
+    class BitAdjacency
+    {
+    public:
+        BitAdjacency();
+        explicit BitAdjacency(const CsrStructure &adjacency);
+
+        int getVertices() const { return vertices; }
+        std::size_t getWordsPerRow() const { return wordsPerRow; }
+        const std::uint64_t *row(int u) const { return bits.data() + static_cast<std::size_t>(u) * wordsPerRow; }
+        bool hasEdge(int u, int v) const;
+
+        // Bitset helpers shared by the kernels below; a bitset holds getWordsPerRow() words
+        std::vector<std::uint64_t> emptySet() const { return std::vector<std::uint64_t>(wordsPerRow, 0); }
+        static bool test(const std::vector<std::uint64_t> &set, int v);
+        static void set(std::vector<std::uint64_t> &set, int v);
+        static std::size_t count(const std::vector<std::uint64_t> &set);
+
+        // Visits everything reachable from start that is not yet in visited, marking it there.
+        // Returns the vertices in visiting order; new neighbours of a vertex are taken in increasing order.
+        std::vector<int> bfs(int start, std::vector<std::uint64_t> &visited) const;
+        std::vector<int> dfs(int start, std::vector<std::uint64_t> &visited) const;
+
+        // BFS 2-coloring of every component, treating u -> v as a constraint color(u) != color(v).
+        // Component roots get the first color. Fills both sides in discovery order; false on a conflict.
+        bool twoColor(std::vector<int> &first, std::vector<int> &second) const;
+
+        // True if the graph has at least minVertices vertices and on average a vertex has at least one
+        // edge per word of its bit row, i.e. a word scan does less work than walking the CSR row.
+        static bool isWorthwhile(const CsrStructure &adjacency, int minVertices = 512);
+
+    private:
+        std::vector<std::uint64_t> bits;
+        std::size_t wordsPerRow;
+        int vertices;
+    };
+
+}
+
+#endif
@@ -0,0 +1,34 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ConnectivityTracker.hpp"
+
+namespace ariel
+{
+
+    ConnectivityTracker::ConnectivityTracker(int numVertices) : sets(numVertices) {}
+
+    ConnectivityTracker::ConnectivityTracker(const Graph &g) : sets(g.getVertices())
+    {
+        const CsrAdjacency &adjacency = g.getCsr();
+        for (int u = 0; u < g.getVertices(); ++u)
+        {
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                sets.unite(u, adjacency.target(e));
+            }
+        }
+    }
+
+    bool ConnectivityTracker::addEdge(int u, int v)
+    {
+        return sets.unite(u, v);
+    }
+
+    void ConnectivityTracker::addEdges(const std::vector<Edge> &edges)
+    {
+        for (const Edge &edge : edges)
+        {
+            sets.unite(edge.from, edge.to);
+        }
+    }
+
+}
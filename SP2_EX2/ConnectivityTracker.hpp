@@ -0,0 +1,38 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef CONNECTIVITY_TRACKER_HPP
+#define CONNECTIVITY_TRACKER_HPP
+
+#include "DisjointSets.hpp"
+#include "Graph.hpp"
+
+namespace ariel
+{
+
+    // Tracks connected components while edges stream in, in near O(1) per edge instead of a full
+    // traversal per check. Edge directions are ignored (weak connectivity); on a symmetric graph
+    // isConnected() agrees with Algorithms::isConnected.
+    class ConnectivityTracker
+    {
+    public:
+        explicit ConnectivityTracker(int numVertices);
+        // Starts from the edges g already has
+        explicit ConnectivityTracker(const Graph &g);
+
+        // Returns true if the edge joined two components
+        bool addEdge(int u, int v);
+        void addEdges(const std::vector<Edge> &edges);
+
+        int getVertices() const { return sets.getElements(); }
+        int getComponentCount() const { return sets.getSetCount(); }
+        bool isConnected() const { return sets.getSetCount() <= 1; }
+        bool sameComponent(int u, int v) { return sets.same(u, v); }
+        int componentOf(int v) { return sets.find(v); }
+        int componentSize(int v) { return sets.setSize(v); }
+
+    private:
+        DisjointSets sets;
+    };
+
+}
+
+#endif
@@ -0,0 +1,456 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ContractionHierarchy.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace ariel
+{
+
+    namespace
+    {
+        const Distance NONE = ShortestPathTree::UNREACHABLE;
+        // Witness searches may give up early: a missed witness only costs a redundant shortcut. Priorities
+        // are estimated with a cheap search and the real contraction uses a thorough one.
+        const std::size_t ESTIMATE_SETTLE_LIMIT = 40;
+        const std::size_t CONTRACT_SETTLE_LIMIT = 500;
+
+        struct Arc
+        {
+            int to;
+            Distance weight;
+            int middle; // bypassed vertex of a shortcut, -1 for an original edge
+        };
+
+        typedef std::vector<std::vector<Arc>> ArcLists;
+
+        // Bounded Dijkstra over the remaining graph, avoiding the vertex being contracted.
+        // It may stop early, so reported distances are upper bounds, which is all a witness needs.
+        class WitnessSearch
+        {
+        public:
+            WitnessSearch(std::size_t n) : distance(n), stamp(n, 0), run(0), heap(n) {}
+
+            void search(const ArcLists &out, int source, int avoid, Distance limit, std::size_t settleLimit)
+            {
+                ++run;
+                heap.clear();
+                reach(source, 0);
+                heap.push(source, 0);
+                std::size_t settled = 0;
+                while (!heap.empty() && settled++ < settleLimit)
+                {
+                    int u = heap.popMin();
+                    Distance du = distance[static_cast<std::size_t>(u)];
+                    if (du > limit)
+                    {
+                        break;
+                    }
+                    for (const Arc &arc : out[static_cast<std::size_t>(u)])
+                    {
+                        if (arc.to == avoid || du + arc.weight > limit || du + arc.weight >= distanceTo(arc.to))
+                        {
+                            continue;
+                        }
+                        bool queued = heap.contains(arc.to);
+                        bool known = distanceTo(arc.to) != NONE;
+                        reach(arc.to, du + arc.weight);
+                        if (queued)
+                        {
+                            heap.decreaseKey(arc.to, du + arc.weight);
+                        }
+                        else if (!known)
+                        {
+                            heap.push(arc.to, du + arc.weight);
+                        }
+                    }
+                }
+            }
+
+            Distance distanceTo(int v) const
+            {
+                std::size_t sv = static_cast<std::size_t>(v);
+                return stamp[sv] == run ? distance[sv] : NONE;
+            }
+
+        private:
+            void reach(int v, Distance d)
+            {
+                std::size_t sv = static_cast<std::size_t>(v);
+                stamp[sv] = run;
+                distance[sv] = d;
+            }
+
+            std::vector<Distance> distance;
+            std::vector<unsigned> stamp;
+            unsigned run;
+            PairingHeap<Distance> heap;
+        };
+
+        // Adds u -> arc.to, or lowers an existing arc between them
+        void addArc(ArcLists &out, ArcLists &in, int u, const Arc &arc)
+        {
+            for (Arc &existing : out[static_cast<std::size_t>(u)])
+            {
+                if (existing.to != arc.to)
+                {
+                    continue;
+                }
+                if (arc.weight < existing.weight)
+                {
+                    existing.weight = arc.weight;
+                    existing.middle = arc.middle;
+                    for (Arc &back : in[static_cast<std::size_t>(arc.to)])
+                    {
+                        if (back.to == u)
+                        {
+                            back.weight = arc.weight;
+                            back.middle = arc.middle;
+                        }
+                    }
+                }
+                return;
+            }
+            out[static_cast<std::size_t>(u)].push_back(arc);
+            in[static_cast<std::size_t>(arc.to)].push_back({u, arc.weight, arc.middle});
+        }
+
+        void removeArc(std::vector<Arc> &arcs, int to)
+        {
+            for (std::size_t i = 0; i < arcs.size(); ++i)
+            {
+                if (arcs[i].to == to)
+                {
+                    arcs[i] = arcs.back();
+                    arcs.pop_back();
+                    return;
+                }
+            }
+        }
+    }
+
+    ContractionHierarchy::ContractionHierarchy(const Graph &g)
+        : graph(g), version(g.getVersion()), vertexCount(static_cast<std::size_t>(g.getVertices())), rank(vertexCount, 0),
+          shortcuts(0), preprocessingSeconds(0), stamp(vertexCount, 0), query(0), forwardDistance(vertexCount), backwardDistance(vertexCount),
+          forwardParent(vertexCount), backwardParent(vertexCount), forwardMiddle(vertexCount), backwardMiddle(vertexCount),
+          forwardHeap(vertexCount), backwardHeap(vertexCount), lastSettled(0)
+    {
+        const CsrAdjacency &adjacency = g.getCsr();
+        if (ShortestPaths::hasNegativeWeights(adjacency))
+        {
+            throw std::invalid_argument("Contraction hierarchies require non-negative weights.");
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        contract(adjacency);
+        preprocessingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void ContractionHierarchy::contract(const CsrAdjacency &adjacency)
+    {
+        std::size_t n = vertexCount;
+        ArcLists out(n), in(n);
+        for (int u = 0; u < adjacency.getVertices(); ++u)
+        {
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                // Self-loops never shorten a path with non-negative weights
+                if (adjacency.target(e) != u)
+                {
+                    out[static_cast<std::size_t>(u)].push_back({adjacency.target(e), adjacency.weight(e), -1});
+                    in[static_cast<std::size_t>(adjacency.target(e))].push_back({u, adjacency.weight(e), -1});
+                }
+            }
+        }
+
+        std::vector<long> deletedNeighbours(n, 0);
+        std::vector<int> neighbourOf(n, -1);
+        WitnessSearch witness(n);
+        std::vector<std::pair<int, Arc>> needed;
+
+        // The arc lists only ever hold arcs between vertices not yet contracted. Fills needed with the
+        // shortcuts contracting v would add and returns its priority.
+        auto simulate = [&](int v, std::size_t settleLimit) -> long
+        {
+            needed.clear();
+            const std::vector<Arc> &outgoing = out[static_cast<std::size_t>(v)];
+            Distance longest = -1;
+            for (const Arc &outArc : outgoing)
+            {
+                longest = std::max(longest, outArc.weight);
+            }
+            for (const Arc &inArc : in[static_cast<std::size_t>(v)])
+            {
+                int u = inArc.to;
+                if (longest < 0)
+                {
+                    break;
+                }
+                witness.search(out, u, v, inArc.weight + longest, settleLimit);
+                for (const Arc &outArc : outgoing)
+                {
+                    if (outArc.to != u && witness.distanceTo(outArc.to) > inArc.weight + outArc.weight)
+                    {
+                        needed.push_back(std::make_pair(u, Arc{outArc.to, inArc.weight + outArc.weight, v}));
+                    }
+                }
+            }
+            long removed = static_cast<long>(outgoing.size() + in[static_cast<std::size_t>(v)].size());
+            return static_cast<long>(needed.size()) - removed + deletedNeighbours[static_cast<std::size_t>(v)];
+        };
+
+        typedef std::pair<long, int> Entry; // (priority, vertex)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> order;
+        for (int v = 0; v < static_cast<int>(n); ++v)
+        {
+            order.push(Entry(simulate(v, ESTIMATE_SETTLE_LIMIT), v));
+        }
+
+        // Arcs of a vertex at the moment it is contracted all lead to higher ranks: its outgoing ones
+        // upward from it, its incoming ones upward into it from the target's side
+        std::vector<std::vector<Arc>> up(n), down(n);
+        int next = 0;
+        while (!order.empty())
+        {
+            int v = order.top().second;
+            order.pop();
+            // Lazy update: re-queue v if its fresh priority no longer comes first
+            long priority = simulate(v, ESTIMATE_SETTLE_LIMIT);
+            if (!order.empty() && priority > order.top().first)
+            {
+                order.push(Entry(priority, v));
+                continue;
+            }
+            simulate(v, CONTRACT_SETTLE_LIMIT);
+            for (const std::pair<int, Arc> &shortcut : needed)
+            {
+                addArc(out, in, shortcut.first, shortcut.second);
+            }
+            std::size_t sv = static_cast<std::size_t>(v);
+            rank[sv] = next++;
+            // Each neighbour counts one deleted neighbour, even if it is linked both ways
+            for (const Arc &arc : out[sv])
+            {
+                removeArc(in[static_cast<std::size_t>(arc.to)], v);
+                ++deletedNeighbours[static_cast<std::size_t>(arc.to)];
+                neighbourOf[static_cast<std::size_t>(arc.to)] = v;
+            }
+            for (const Arc &arc : in[sv])
+            {
+                removeArc(out[static_cast<std::size_t>(arc.to)], v);
+                if (neighbourOf[static_cast<std::size_t>(arc.to)] != v)
+                {
+                    ++deletedNeighbours[static_cast<std::size_t>(arc.to)];
+                }
+            }
+            up[sv].swap(out[sv]);
+            down[sv].swap(in[sv]);
+        }
+        for (const std::vector<Arc> &arcs : up)
+        {
+            for (const Arc &arc : arcs)
+            {
+                shortcuts += arc.middle == -1 ? 0 : 1;
+            }
+        }
+        for (const std::vector<Arc> &arcs : down)
+        {
+            for (const Arc &arc : arcs)
+            {
+                shortcuts += arc.middle == -1 ? 0 : 1;
+            }
+        }
+
+        auto flatten = [n](const std::vector<std::vector<Arc>> &lists, UpwardGraph &result)
+        {
+            result.offsets.assign(1, 0);
+            for (std::size_t u = 0; u < n; ++u)
+            {
+                for (const Arc &arc : lists[u])
+                {
+                    result.targets.push_back(arc.to);
+                    result.weights.push_back(arc.weight);
+                    result.middles.push_back(arc.middle);
+                }
+                result.offsets.push_back(result.targets.size());
+            }
+        };
+        flatten(up, forwardUp);
+        flatten(down, backwardUp);
+    }
+
+    void ContractionHierarchy::checkQuery(int from, int to) const
+    {
+        if (version != graph.getVersion())
+        {
+            throw std::logic_error("Contraction hierarchy is out of date.");
+        }
+        if (from < 0 || to < 0 || static_cast<std::size_t>(from) >= vertexCount || static_cast<std::size_t>(to) >= vertexCount)
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+    }
+
+    int ContractionHierarchy::search(int source, int target, Distance &best)
+    {
+        if (++query == 0)
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            query = 1;
+        }
+        forwardHeap.clear();
+        backwardHeap.clear();
+        lastSettled = 0;
+        auto touch = [&](int v)
+        {
+            std::size_t sv = static_cast<std::size_t>(v);
+            if (stamp[sv] != query)
+            {
+                stamp[sv] = query;
+                forwardDistance[sv] = backwardDistance[sv] = NONE;
+                forwardParent[sv] = backwardParent[sv] = -1;
+            }
+        };
+        touch(source);
+        touch(target);
+        forwardDistance[static_cast<std::size_t>(source)] = 0;
+        backwardDistance[static_cast<std::size_t>(target)] = 0;
+        forwardHeap.push(source, 0);
+        backwardHeap.push(target, 0);
+
+        best = NONE;
+        int meet = -1;
+        while (!forwardHeap.empty() || !backwardHeap.empty())
+        {
+            bool forward = !forwardHeap.empty() && (backwardHeap.empty() || forwardHeap.key(forwardHeap.top()) <= backwardHeap.key(backwardHeap.top()));
+            PairingHeap<Distance> &heap = forward ? forwardHeap : backwardHeap;
+            // Upward searches cannot stop at the first meeting; a side is done once it cannot beat best
+            if (best != NONE && heap.key(heap.top()) >= best)
+            {
+                heap.clear();
+                continue;
+            }
+
+            const UpwardGraph &upward = forward ? forwardUp : backwardUp;
+            std::vector<Distance> &distance = forward ? forwardDistance : backwardDistance;
+            std::vector<Distance> &other = forward ? backwardDistance : forwardDistance;
+            std::vector<int> &parent = forward ? forwardParent : backwardParent;
+            std::vector<int> &middle = forward ? forwardMiddle : backwardMiddle;
+
+            int u = heap.popMin();
+            ++lastSettled;
+            std::size_t su = static_cast<std::size_t>(u);
+            Distance du = distance[su];
+            if (other[su] != NONE && (best == NONE || du + other[su] < best))
+            {
+                best = du + other[su];
+                meet = u;
+            }
+            for (std::size_t e = upward.offsets[su]; e < upward.offsets[su + 1]; ++e)
+            {
+                int v = upward.targets[e];
+                touch(v);
+                std::size_t sv = static_cast<std::size_t>(v);
+                Distance candidate = du + upward.weights[e];
+                if (candidate >= distance[sv])
+                {
+                    continue;
+                }
+                if (heap.contains(v))
+                {
+                    heap.decreaseKey(v, candidate);
+                }
+                else
+                {
+                    heap.push(v, candidate);
+                }
+                distance[sv] = candidate;
+                parent[sv] = u;
+                middle[sv] = upward.middles[e];
+            }
+        }
+        return meet;
+    }
+
+    int ContractionHierarchy::middleOf(const UpwardGraph &upward, int at, int other) const
+    {
+        std::size_t sa = static_cast<std::size_t>(at);
+        for (std::size_t e = upward.offsets[sa]; e < upward.offsets[sa + 1]; ++e)
+        {
+            if (upward.targets[e] == other)
+            {
+                return upward.middles[e];
+            }
+        }
+        throw std::logic_error("Shortcut refers to a missing arc.");
+    }
+
+    void ContractionHierarchy::unpack(int a, int b, int middle, std::vector<int> &out) const
+    {
+        // Explicit stack of arcs still to expand, leftmost on top
+        struct Pending
+        {
+            int from;
+            int to;
+            int middle;
+        };
+        std::vector<Pending> pending(1, Pending{a, b, middle});
+        while (!pending.empty())
+        {
+            Pending arc = pending.back();
+            pending.pop_back();
+            if (arc.middle == -1)
+            {
+                out.push_back(arc.to);
+                continue;
+            }
+            // The middle was contracted before both ends: from -> middle is stored at the middle as a
+            // backward arc, middle -> to as a forward one
+            int m = arc.middle;
+            pending.push_back(Pending{m, arc.to, middleOf(forwardUp, m, arc.to)});
+            pending.push_back(Pending{arc.from, m, middleOf(backwardUp, m, arc.from)});
+        }
+    }
+
+    Distance ContractionHierarchy::distance(int from, int to)
+    {
+        checkQuery(from, to);
+        Distance best;
+        search(from, to, best);
+        return best;
+    }
+
+    std::vector<int> ContractionHierarchy::path(int from, int to)
+    {
+        checkQuery(from, to);
+        Distance best;
+        int meet = search(from, to, best);
+        std::vector<int> vertices;
+        if (meet == -1)
+        {
+            return vertices;
+        }
+
+        // Upward arcs of the forward search, from `from` to the meeting vertex
+        std::vector<int> chain;
+        for (int v = meet; v != -1; v = forwardParent[static_cast<std::size_t>(v)])
+        {
+            chain.push_back(v);
+        }
+        std::reverse(chain.begin(), chain.end());
+        vertices.push_back(from);
+        for (std::size_t i = 1; i < chain.size(); ++i)
+        {
+            unpack(chain[i - 1], chain[i], forwardMiddle[static_cast<std::size_t>(chain[i])], vertices);
+        }
+        // Then the backward search's arcs from the meeting vertex down to `to`
+        for (int v = meet; backwardParent[static_cast<std::size_t>(v)] != -1; v = backwardParent[static_cast<std::size_t>(v)])
+        {
+            unpack(v, backwardParent[static_cast<std::size_t>(v)], backwardMiddle[static_cast<std::size_t>(v)], vertices);
+        }
+        return vertices;
+    }
+
+}
@@ -0,0 +1,75 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include "PairingHeap.hpp"
+#include "ShortestPaths.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ariel
+{
+
+    // Contraction hierarchy for repeated point-to-point queries on a static graph with non-negative
+    // weights. Preprocessing contracts the vertices one at a time, lowest priority first. The priority
+    // is the edge difference (shortcuts needed minus edges removed) plus the number of already
+    // contracted neighbours, re-evaluated lazily. A shortcut u -> w replaces u -> v -> w whenever a
+    // bounded witness search finds no other path at least as short. Queries run two upward Dijkstra
+    // searches, which settle only a few hundred vertices even on large graphs, and unpack shortcuts
+    // into original edges.
+    class ContractionHierarchy
+    {
+    public:
+        explicit ContractionHierarchy(const Graph &g);
+
+        // ShortestPathTree::UNREACHABLE if there is no path
+        Distance distance(int from, int to);
+        // Vertices from `from` to `to` over original edges, or an empty vector if there is no path
+        std::vector<int> path(int from, int to);
+
+        // Position of v in the contraction order; 0 was contracted first
+        int getRank(int v) const { return rank[static_cast<std::size_t>(v)]; }
+        std::size_t getShortcutCount() const { return shortcuts; }
+        double getPreprocessingSeconds() const { return preprocessingSeconds; }
+        // Vertices settled by the last query, both directions together
+        std::size_t getLastSettled() const { return lastSettled; }
+
+    private:
+        // Arcs leading upward in the hierarchy, grouped by vertex. A shortcut's middle is the vertex it
+        // bypasses; -1 marks an original edge.
+        struct UpwardGraph
+        {
+            std::vector<std::size_t> offsets;
+            std::vector<int> targets;
+            std::vector<Distance> weights;
+            std::vector<int> middles;
+        };
+
+        void contract(const CsrAdjacency &adjacency);
+        void checkQuery(int from, int to) const;
+        // Returns the vertex where the searches meet, or -1, and the distance in best
+        int search(int source, int target, Distance &best);
+        // Appends the original path of arc a -> b (bypassing middle), without a itself
+        void unpack(int a, int b, int middle, std::vector<int> &out) const;
+        int middleOf(const UpwardGraph &upward, int at, int other) const;
+
+        const Graph &graph;
+        std::uint64_t version;
+        std::size_t vertexCount;
+        std::vector<int> rank;
+        UpwardGraph forwardUp;  // at u: u -> v with rank[v] > rank[u]
+        UpwardGraph backwardUp; // at v: u -> v with rank[u] > rank[v], stored as target u
+        std::size_t shortcuts;
+        double preprocessingSeconds;
+
+        std::vector<unsigned> stamp;
+        unsigned query;
+        std::vector<Distance> forwardDistance, backwardDistance;
+        std::vector<int> forwardParent, backwardParent, forwardMiddle, backwardMiddle;
+        PairingHeap<Distance> forwardHeap, backwardHeap;
+        std::size_t lastSettled;
+    };
+
+}
+
+#endif
@@ -0,0 +1,39 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "CpuFeatures.hpp"
+#include <atomic>
+
+namespace ariel
+{
+
+    namespace
+    {
+        std::atomic<bool> vectorKernels(true);
+
+        bool detectAvx2()
+        {
+#if ARIEL_X86_DISPATCH
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#else
+            return false;
+#endif
+        }
+    }
+
+    bool CpuFeatures::hasAvx2()
+    {
+        static const bool supported = detectAvx2();
+        return supported && vectorKernels.load(std::memory_order_relaxed);
+    }
+
+    void CpuFeatures::setVectorKernelsEnabled(bool enabled)
+    {
+        vectorKernels.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool CpuFeatures::vectorKernelsEnabled()
+    {
+        return vectorKernels.load(std::memory_order_relaxed);
+    }
+
+}
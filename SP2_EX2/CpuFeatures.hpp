@@ -0,0 +1,31 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+// Vector kernels are compiled per function with GCC/Clang target attributes and picked at run time,
+// so the library itself still builds for (and runs on) plain x86-64 and other architectures.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ARIEL_X86_DISPATCH 1
+#define ARIEL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ARIEL_X86_DISPATCH 0
+#define ARIEL_TARGET_AVX2
+#endif
+
+namespace ariel
+{
+
+    class CpuFeatures
+    {
+    public:
+        // True if the running CPU supports AVX2 and vector kernels have not been disabled
+        static bool hasAvx2();
+
+        // Forces the scalar fallbacks, e.g. to compare them against the vector kernels
+        static void setVectorKernelsEnabled(bool enabled);
+        static bool vectorKernelsEnabled();
+    };
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "CsrAdjacency.hpp"
+
+namespace ariel
+{
+
+    std::size_t CsrStructure::find(int u, int v) const
+    {
+        std::vector<int>::const_iterator first = targets.begin() + static_cast<std::ptrdiff_t>(rowBegin(u));
+        std::vector<int>::const_iterator last = targets.begin() + static_cast<std::ptrdiff_t>(rowEnd(u));
+        std::vector<int>::const_iterator it = std::lower_bound(first, last, v);
+        if (it == last || *it != v)
+        {
+            return getEdgeCount();
+        }
+        return static_cast<std::size_t>(it - targets.begin());
+    }
+
+    template class BasicCsrAdjacency<int>;
+
+}
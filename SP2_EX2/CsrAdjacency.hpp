@@ -0,0 +1,221 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef CSR_ADJACENCY_HPP
+#define CSR_ADJACENCY_HPP
+
+#include "DenseMatrix.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace ariel
+{
+
+    // A directed, weighted edge u -> v. A weight of 0 means "no edge" in the matrix representation,
+    // so edge lists may not contain zero weights either.
+    template <typename W>
+    struct BasicEdge
+    {
+        int from;
+        int to;
+        W weight;
+    };
+    typedef BasicEdge<int> Edge;
+
+    // The edges of a compressed sparse row graph without their weights: the out-neighbours of vertex
+    // u are targets[offsets[u]] .. targets[offsets[u + 1] - 1], sorted. Traversals that ignore weights
+    // (BFS, SCC, cycles, 2-coloring, the bit rows) take this, so they serve every weight type.
+    class CsrStructure
+    {
+    public:
+        CsrStructure() : offsets(1, 0), vertices(0) {}
+
+        int getVertices() const { return vertices; }
+        std::size_t getEdgeCount() const { return targets.size(); }
+
+        std::size_t rowBegin(int u) const { return offsets[static_cast<std::size_t>(u)]; }
+        std::size_t rowEnd(int u) const { return offsets[static_cast<std::size_t>(u) + 1]; }
+        std::size_t degree(int u) const { return rowEnd(u) - rowBegin(u); }
+        int target(std::size_t e) const { return targets[e]; }
+
+        // Position of u -> v in targets, or getEdgeCount() if there is no such edge. O(log degree(u)).
+        std::size_t find(int u, int v) const;
+
+        const std::vector<std::size_t> &getOffsets() const { return offsets; }
+        const std::vector<int> &getTargets() const { return targets; }
+
+    protected:
+        std::vector<std::size_t> offsets;
+        std::vector<int> targets;
+        int vertices;
+    };
+
+    // Compressed sparse row adjacency with weights of type W: the weight of the edge at position e of
+    // targets is weights[e]. ariel::CsrAdjacency is the int one.
+    template <typename W>
+    class BasicCsrAdjacency : public CsrStructure
+    {
+    public:
+        typedef W Weight;
+
+        // Row-major n * n cells, row u at cells + u * stride; zero cells are not edges
+        static BasicCsrAdjacency fromCells(const W *cells, std::size_t n, std::size_t stride);
+        static BasicCsrAdjacency fromMatrix(const DenseMatrix &matrix) { return fromCells(matrix.data(), matrix.size(), matrix.stride()); }
+        static BasicCsrAdjacency fromEdges(int numVertices, const std::vector<BasicEdge<W>> &edges);
+
+        // Returns the graph with every edge reversed (the in-edges of each vertex, sorted by source).
+        BasicCsrAdjacency transpose() const;
+
+        W weight(std::size_t e) const { return weights[e]; }
+
+        // Returns the weight of u -> v, or 0 if there is no such edge. O(log degree(u)).
+        W edgeWeight(int u, int v) const
+        {
+            std::size_t e = find(u, v);
+            return e == getEdgeCount() ? W() : weights[e];
+        }
+
+        const std::vector<W> &getWeights() const { return weights; }
+
+        bool operator==(const BasicCsrAdjacency &other) const
+        {
+            return vertices == other.vertices && offsets == other.offsets && targets == other.targets && weights == other.weights;
+        }
+
+    private:
+        std::vector<W> weights;
+    };
+
+    typedef BasicCsrAdjacency<int> CsrAdjacency;
+
+    template <typename W>
+    BasicCsrAdjacency<W> BasicCsrAdjacency<W>::fromCells(const W *cells, std::size_t n, std::size_t stride)
+    {
+        BasicCsrAdjacency csr;
+        csr.vertices = static_cast<int>(n);
+        csr.offsets.assign(n + 1, 0);
+
+        for (std::size_t u = 0; u < n; ++u)
+        {
+            const W *row = cells + u * stride;
+            for (std::size_t v = 0; v < n; ++v)
+            {
+                if (row[v] != W())
+                {
+                    csr.targets.push_back(static_cast<int>(v));
+                    csr.weights.push_back(row[v]);
+                }
+            }
+            csr.offsets[u + 1] = csr.targets.size();
+        }
+        return csr;
+    }
+
+    template <typename W>
+    BasicCsrAdjacency<W> BasicCsrAdjacency<W>::fromEdges(int numVertices, const std::vector<BasicEdge<W>> &edges)
+    {
+        if (numVertices <= 0)
+        {
+            throw std::invalid_argument("Invalid graph: The number of vertices must be positive.");
+        }
+        std::size_t n = static_cast<std::size_t>(numVertices);
+        for (const BasicEdge<W> &edge : edges)
+        {
+            if (edge.from < 0 || edge.from >= numVertices || edge.to < 0 || edge.to >= numVertices)
+            {
+                throw std::invalid_argument("Invalid graph: Edge endpoint out of range.");
+            }
+            if (edge.weight == W())
+            {
+                throw std::invalid_argument("Invalid graph: Edge weight 0 denotes a missing edge.");
+            }
+        }
+
+        // Two counting-sort passes (by target, then stably by source) give rows sorted by target in O(V + E)
+        std::vector<std::size_t> byTarget(edges.size());
+        std::vector<std::size_t> count(n + 1, 0);
+        for (const BasicEdge<W> &edge : edges)
+        {
+            ++count[static_cast<std::size_t>(edge.to) + 1];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            count[i + 1] += count[i];
+        }
+        for (std::size_t i = 0; i < edges.size(); ++i)
+        {
+            byTarget[count[static_cast<std::size_t>(edges[i].to)]++] = i;
+        }
+
+        BasicCsrAdjacency csr;
+        csr.vertices = numVertices;
+        csr.offsets.assign(n + 1, 0);
+        csr.targets.resize(edges.size());
+        csr.weights.resize(edges.size());
+        for (const BasicEdge<W> &edge : edges)
+        {
+            ++csr.offsets[static_cast<std::size_t>(edge.from) + 1];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            csr.offsets[i + 1] += csr.offsets[i];
+        }
+        std::vector<std::size_t> next(csr.offsets.begin(), csr.offsets.end() - 1);
+        for (std::size_t i : byTarget)
+        {
+            std::size_t slot = next[static_cast<std::size_t>(edges[i].from)]++;
+            csr.targets[slot] = edges[i].to;
+            csr.weights[slot] = edges[i].weight;
+        }
+
+        for (std::size_t u = 0; u < n; ++u)
+        {
+            for (std::size_t e = csr.offsets[u] + 1; e < csr.offsets[u + 1]; ++e)
+            {
+                if (csr.targets[e] == csr.targets[e - 1])
+                {
+                    throw std::invalid_argument("Invalid graph: Duplicate edge in edge list.");
+                }
+            }
+        }
+        return csr;
+    }
+
+    template <typename W>
+    BasicCsrAdjacency<W> BasicCsrAdjacency<W>::transpose() const
+    {
+        std::size_t n = static_cast<std::size_t>(vertices);
+        BasicCsrAdjacency result;
+        result.vertices = vertices;
+        result.offsets.assign(n + 1, 0);
+        result.targets.resize(targets.size());
+        result.weights.resize(weights.size());
+
+        for (int v : targets)
+        {
+            ++result.offsets[static_cast<std::size_t>(v) + 1];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            result.offsets[i + 1] += result.offsets[i];
+        }
+        // Sources are visited in increasing order, so every reversed row comes out sorted
+        std::vector<std::size_t> next(result.offsets.begin(), result.offsets.end() - 1);
+        for (std::size_t u = 0; u < n; ++u)
+        {
+            for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+            {
+                std::size_t slot = next[static_cast<std::size_t>(targets[e])]++;
+                result.targets[slot] = static_cast<int>(u);
+                result.weights[slot] = weights[e];
+            }
+        }
+        return result;
+    }
+
+    // The int adjacency is compiled once, in CsrAdjacency.cpp
+    extern template class BasicCsrAdjacency<int>;
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "DenseMatrix.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace ariel
+{
+
+    const std::size_t DenseMatrix::ALIGNMENT;
+    const std::size_t DenseMatrix::STRIDE_MULTIPLE;
+
+    DenseMatrix::DenseMatrix() : buffer(nullptr), n(0), rowStride(0) {}
+
+    DenseMatrix::DenseMatrix(std::size_t size, int value) : buffer(nullptr), n(0), rowStride(0)
+    {
+        allocate(size);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::fill(rowData(i), rowData(i) + n, value);
+        }
+    }
+
+    DenseMatrix::DenseMatrix(const std::vector<std::vector<int>> &matrix) : buffer(nullptr), n(0), rowStride(0)
+    {
+        allocate(matrix.size());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::copy(matrix[i].begin(), matrix[i].end(), rowData(i));
+        }
+    }
+
+    DenseMatrix::DenseMatrix(const DenseMatrix &other) : buffer(nullptr), n(0), rowStride(0)
+    {
+        allocate(other.n);
+        if (buffer != nullptr)
+        {
+            std::memcpy(buffer, other.buffer, n * rowStride * sizeof(int));
+        }
+    }
+
+    DenseMatrix::DenseMatrix(DenseMatrix &&other) noexcept : buffer(other.buffer), n(other.n), rowStride(other.rowStride)
+    {
+        other.buffer = nullptr;
+        other.n = 0;
+        other.rowStride = 0;
+    }
+
+    DenseMatrix &DenseMatrix::operator=(const DenseMatrix &other)
+    {
+        if (this != &other)
+        {
+            DenseMatrix copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    DenseMatrix &DenseMatrix::operator=(DenseMatrix &&other) noexcept
+    {
+        if (this != &other)
+        {
+            std::free(buffer);
+            buffer = other.buffer;
+            n = other.n;
+            rowStride = other.rowStride;
+            other.buffer = nullptr;
+            other.n = 0;
+            other.rowStride = 0;
+        }
+        return *this;
+    }
+
+    DenseMatrix::~DenseMatrix()
+    {
+        std::free(buffer);
+    }
+
+    void DenseMatrix::clear()
+    {
+        std::free(buffer);
+        buffer = nullptr;
+        n = 0;
+        rowStride = 0;
+    }
+
+    void DenseMatrix::allocate(std::size_t size)
+    {
+        n = size;
+        rowStride = (size + STRIDE_MULTIPLE - 1) / STRIDE_MULTIPLE * STRIDE_MULTIPLE;
+        if (size == 0)
+        {
+            return;
+        }
+        void *memory = nullptr;
+        if (posix_memalign(&memory, ALIGNMENT, n * rowStride * sizeof(int)) != 0)
+        {
+            throw std::bad_alloc();
+        }
+        buffer = static_cast<int *>(memory);
+        std::memset(buffer, 0, n * rowStride * sizeof(int));
+    }
+
+    std::vector<std::vector<int>> DenseMatrix::toVector() const
+    {
+        std::vector<std::vector<int>> matrix(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            matrix[i].assign(rowData(i), rowData(i) + n);
+        }
+        return matrix;
+    }
+
+    bool DenseMatrix::operator==(const DenseMatrix &other) const
+    {
+        if (n != other.n)
+        {
+            return false;
+        }
+        // Padding is always zero, so whole strides can be compared at once
+        return n == 0 || std::memcmp(buffer, other.buffer, n * rowStride * sizeof(int)) == 0;
+    }
+
+}
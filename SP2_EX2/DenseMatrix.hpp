@@ -0,0 +1,75 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef DENSE_MATRIX_HPP
+#define DENSE_MATRIX_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ariel
+{
+
+    // Span-like view of one matrix row. Valid until the owning matrix is reallocated.
+    template <typename T>
+    class RowView
+    {
+    public:
+        RowView(T *data, std::size_t size) : first(data), count(size) {}
+
+        T &operator[](std::size_t i) const { return first[i]; }
+        std::size_t size() const { return count; }
+        T *data() const { return first; }
+        T *begin() const { return first; }
+        T *end() const { return first + count; }
+
+    private:
+        T *first;
+        std::size_t count;
+    };
+
+    // Square int matrix stored row-major in one cache-line aligned buffer. Every row starts on a
+    // cache line: the stride is padded to a multiple of 16 ints and the padding is always zero,
+    // so vector kernels may read whole strides.
+    class DenseMatrix
+    {
+    public:
+        static const std::size_t ALIGNMENT = 64;
+        static const std::size_t STRIDE_MULTIPLE = ALIGNMENT / sizeof(int);
+
+        DenseMatrix();
+        explicit DenseMatrix(std::size_t size, int value = 0);
+        explicit DenseMatrix(const std::vector<std::vector<int>> &matrix);
+        DenseMatrix(const DenseMatrix &other);
+        DenseMatrix(DenseMatrix &&other) noexcept;
+        DenseMatrix &operator=(const DenseMatrix &other);
+        DenseMatrix &operator=(DenseMatrix &&other) noexcept;
+        ~DenseMatrix();
+
+        std::size_t size() const { return n; }
+        std::size_t stride() const { return rowStride; }
+        bool empty() const { return n == 0; }
+        void clear();
+
+        int *data() { return buffer; }
+        const int *data() const { return buffer; }
+        int *rowData(std::size_t i) { return buffer + i * rowStride; }
+        const int *rowData(std::size_t i) const { return buffer + i * rowStride; }
+
+        RowView<int> operator[](std::size_t i) { return RowView<int>(rowData(i), n); }
+        RowView<const int> operator[](std::size_t i) const { return RowView<const int>(rowData(i), n); }
+
+        std::vector<std::vector<int>> toVector() const;
+
+        bool operator==(const DenseMatrix &other) const;
+        bool operator!=(const DenseMatrix &other) const { return !(*this == other); }
+
+    private:
+        void allocate(std::size_t size);
+
+        int *buffer;
+        std::size_t n;
+        std::size_t rowStride;
+    };
+
+}
+
+#endif
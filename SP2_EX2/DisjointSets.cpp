@@ -0,0 +1,75 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "DisjointSets.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace ariel
+{
+
+    DisjointSets::DisjointSets(int n)
+    {
+        if (n < 0)
+        {
+            throw std::invalid_argument("Number of elements must be non-negative.");
+        }
+        std::size_t count = static_cast<std::size_t>(n);
+        parent.resize(count);
+        rank.assign(count, 0);
+        size.assign(count, 1);
+        for (std::size_t v = 0; v < count; ++v)
+        {
+            parent[v] = static_cast<int>(v);
+        }
+        sets = n;
+    }
+
+    void DisjointSets::check(int v) const
+    {
+        if (v < 0 || static_cast<std::size_t>(v) >= parent.size())
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+    }
+
+    int DisjointSets::find(int v)
+    {
+        check(v);
+        int root = v;
+        while (parent[static_cast<std::size_t>(root)] != root)
+        {
+            root = parent[static_cast<std::size_t>(root)];
+        }
+        // Path compression, iteratively so long chains cannot overflow the stack
+        while (parent[static_cast<std::size_t>(v)] != root)
+        {
+            int next = parent[static_cast<std::size_t>(v)];
+            parent[static_cast<std::size_t>(v)] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    bool DisjointSets::unite(int a, int b)
+    {
+        std::size_t ra = static_cast<std::size_t>(find(a));
+        std::size_t rb = static_cast<std::size_t>(find(b));
+        if (ra == rb)
+        {
+            return false;
+        }
+        // Union by rank: hang the shallower tree below the deeper one
+        if (rank[ra] < rank[rb])
+        {
+            std::swap(ra, rb);
+        }
+        parent[rb] = static_cast<int>(ra);
+        size[ra] += size[rb];
+        if (rank[ra] == rank[rb])
+        {
+            ++rank[ra];
+        }
+        --sets;
+        return true;
+    }
+
+}
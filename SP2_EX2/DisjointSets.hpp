@@ -0,0 +1,39 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef DISJOINT_SETS_HPP
+#define DISJOINT_SETS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ariel
+{
+
+    // Union-find over 0..n-1 with path compression and union by rank: a sequence of m operations
+    // costs O(m α(n)), effectively constant per operation.
+    class DisjointSets
+    {
+    public:
+        explicit DisjointSets(int n = 0);
+
+        // Representative of v's set
+        int find(int v);
+        // Merges the sets of a and b; false if they already were one set
+        bool unite(int a, int b);
+        bool same(int a, int b) { return find(a) == find(b); }
+
+        int getElements() const { return static_cast<int>(parent.size()); }
+        int getSetCount() const { return sets; }
+        int setSize(int v) { return size[static_cast<std::size_t>(find(v))]; }
+
+    private:
+        void check(int v) const;
+
+        std::vector<int> parent;
+        std::vector<unsigned char> rank; // tree heights stay below log2(n), so 8 bits are plenty
+        std::vector<int> size;
+        int sets;
+    };
+
+}
+
+#endif
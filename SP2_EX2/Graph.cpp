@@ -1,12 +1,33 @@
 // Id: 211696521 Mail: galh2011@icloud.com
 #include "Graph.hpp"
+#include "MatrixProduct.hpp"
+#include <atomic>
 #include <stdexcept>
 #include <sstream>
 
 namespace ariel
 {
 
-    Graph::Graph() : vertices(0) {}
+    const std::size_t Graph::PARALLEL_CELLS;
+
+    namespace
+    {
+        std::atomic<std::uint64_t> versionCounter(0);
+
+        // One empty matrix shared by every graph without one, so default construction allocates no matrix
+        const std::shared_ptr<DenseMatrix> &emptyMatrix()
+        {
+            static const std::shared_ptr<DenseMatrix> empty = std::make_shared<DenseMatrix>();
+            return empty;
+        }
+    }
+
+    std::uint64_t nextGraphVersion()
+    {
+        return ++versionCounter;
+    }
+
+    Graph::BasicGraph() : adjacencyMatrix(emptyMatrix()), statistics(std::make_shared<Statistics>(0)), vertices(0), dense(true), version(nextGraphVersion()), views(std::make_shared<AdjacencyViews<int>>()) {}
 
     void Graph::loadGraph(const std::vector<std::vector<int>> &graph)
     {
@@ -14,14 +35,115 @@ namespace ariel
         {
             throw std::invalid_argument("Invalid graph: The graph is not a square matrix.");
         }
-        adjacencyMatrix = graph;
+        adjacencyMatrix = std::make_shared<DenseMatrix>(graph);
         vertices = static_cast<int>(graph.size());
+        dense = true;
+        invalidateCaches();
+        countStatistics();
+    }
+
+    void Graph::loadGraph(int numVertices, const std::vector<Edge> &edges)
+    {
+        CsrAdjacency loaded = CsrAdjacency::fromEdges(numVertices, edges);
+        adjacencyMatrix = emptyMatrix();
+        vertices = numVertices;
+        dense = false;
+        invalidateCaches();
+        views->csr([&loaded]()
+                   { return std::move(loaded); });
+        countStatistics();
+    }
+
+    const CsrAdjacency &Graph::getCsr() const
+    {
+        const DenseMatrix &matrix = *adjacencyMatrix;
+        return views->csr([&matrix]()
+                          { return CsrAdjacency::fromMatrix(matrix); });
+    }
+
+    const CsrAdjacency &Graph::getReverseCsr() const
+    {
+        return views->reverseCsr(getCsr());
+    }
+
+    const BitAdjacency &Graph::getBitAdjacency() const
+    {
+        return views->bitAdjacency(getCsr());
+    }
+
+    void Graph::invalidateCaches()
+    {
+        version = nextGraphVersion();
+        views = std::make_shared<AdjacencyViews<int>>();
+    }
+
+    std::size_t Graph::checkedVertex(int u) const
+    {
+        if (u < 0 || u >= vertices)
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+        return static_cast<std::size_t>(u);
+    }
+
+    void Graph::countStatistics()
+    {
+        std::size_t n = static_cast<std::size_t>(vertices);
+        std::shared_ptr<Statistics> counted = std::make_shared<Statistics>(n);
+        if (dense)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const int *row = adjacencyMatrix->rowData(i);
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    counted->addCell(i, j, row[j]);
+                }
+            }
+        }
+        else
+        {
+            const CsrAdjacency &csr = getCsr();
+            for (int u = 0; u < vertices; ++u)
+            {
+                for (std::size_t e = csr.rowBegin(u); e < csr.rowEnd(u); ++e)
+                {
+                    counted->addCell(static_cast<std::size_t>(u), static_cast<std::size_t>(csr.target(e)), csr.weight(e));
+                }
+            }
+        }
+        statistics = counted;
+    }
+
+    void Graph::requireDense() const
+    {
+        if (!dense)
+        {
+            throw std::logic_error("Matrix operators require a graph loaded from an adjacency matrix.");
+        }
+    }
+
+    std::vector<int> Graph::getRow(int u) const
+    {
+        if (dense)
+        {
+            RowView<const int> row = getAdjacencyMatrix()[static_cast<std::size_t>(u)];
+            return std::vector<int>(row.begin(), row.end());
+        }
+        const CsrAdjacency &csr = getCsr();
+        std::vector<int> row(static_cast<std::size_t>(vertices), 0);
+        for (std::size_t e = csr.rowBegin(u); e < csr.rowEnd(u); ++e)
+        {
+            row[static_cast<std::size_t>(csr.target(e))] = csr.weight(e);
+        }
+        return row;
     }
 
     void Graph::printGraph() const
     {
-        for (const auto &row : adjacencyMatrix)
+        for (int u = 0; u < vertices; ++u)
         {
+            const std::vector<int> row = getRow(u);
             for (std::vector<int>::size_type i = 0; i < row.size(); ++i)
             {
                 std::cout << row[i];
@@ -36,16 +158,17 @@ namespace ariel
 
     std::string Graph::toString() const {
         std::ostringstream oss;
-        for (size_t i = 0; i < adjacencyMatrix.size(); ++i) {
+        for (int i = 0; i < vertices; ++i) {
+            const std::vector<int> row = getRow(i);
             oss << "[";
-            for (size_t j = 0; j < adjacencyMatrix[i].size(); ++j) {
-                oss << adjacencyMatrix[i][j];
-                if (j != adjacencyMatrix[i].size() - 1) {
+            for (size_t j = 0; j < row.size(); ++j) {
+                oss << row[j];
+                if (j != row.size() - 1) {
                     oss << ", ";
                 }
             }
             oss << "]";
-            if (i != adjacencyMatrix.size() - 1) {
+            if (i != vertices - 1) {
                 oss << "\n";
             }
         }
@@ -65,70 +188,14 @@ namespace ariel
         return true;
     }
 
-    Graph Graph::operator+(const Graph &other) const
-    {
-        if (vertices != other.vertices)
-        {
-            throw std::invalid_argument("Graphs must be of the same size to add.");
-        }
-        Graph result = *this;
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
-        {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
-            {
-                result.adjacencyMatrix[i][j] += other.adjacencyMatrix[i][j];
-            }
-        }
-        return result;
-    }
-
     Graph &Graph::operator+=(const Graph &other)
     {
-        if (vertices != other.vertices)
-        {
-            throw std::invalid_argument("Graphs must be of the same size to add.");
-        }
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
-        {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
-            {
-                adjacencyMatrix[i][j] += other.adjacencyMatrix[i][j];
-            }
-        }
-        return *this;
-    }
-
-    Graph Graph::operator-(const Graph &other) const
-    {
-        if (vertices != other.vertices)
-        {
-            throw std::invalid_argument("Graphs must be of the same size to subtract.");
-        }
-        Graph result = *this;
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
-        {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
-            {
-                result.adjacencyMatrix[i][j] -= other.adjacencyMatrix[i][j];
-            }
-        }
-        return result;
+        return *this = *this + other;
     }
 
     Graph &Graph::operator-=(const Graph &other)
     {
-        if (vertices != other.vertices)
-        {
-            throw std::invalid_argument("Graphs must be of the same size to subtract.");
-        }
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
-        {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
-            {
-                adjacencyMatrix[i][j] -= other.adjacencyMatrix[i][j];
-            }
-        }
-        return *this;
+        return *this = *this - other;
     }
 
     Graph Graph::operator+() const
@@ -136,103 +203,45 @@ namespace ariel
         return *this;
     }
 
-    Graph Graph::operator-() const
-    {
-        Graph result = *this;
-        for (auto &row : result.adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                value = -value;
-            }
-        }
-        return result;
-    }
-
-    Graph Graph::operator*(int scalar) const
-    {
-        Graph result = *this;
-        for (auto &row : result.adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                value *= scalar;
-            }
-        }
-        return result;
-    }
-
     Graph &Graph::operator*=(int scalar)
     {
-        for (auto &row : adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                value *= scalar;
-            }
-        }
-        return *this;
+        return *this = *this * scalar;
     }
 
     Graph Graph::operator*(const Graph &other) const
     {
+        requireDense();
+        other.requireDense();
         if (vertices != other.vertices)
         {
             throw std::invalid_argument("Graphs must be of the same size to multiply.");
         }
         Graph result;
-        result.adjacencyMatrix.resize(adjacencyMatrix.size(), std::vector<int>(adjacencyMatrix.size(), 0));
+        result.adjacencyMatrix = std::make_shared<DenseMatrix>();
+        MatrixProduct::multiply(*adjacencyMatrix, *other.adjacencyMatrix, *result.adjacencyMatrix);
         result.vertices = vertices;
-
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
-        {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
-            {
-                for (std::vector<int>::size_type k = 0; k < adjacencyMatrix.size(); ++k)
-                {
-                    result.adjacencyMatrix[i][j] += adjacencyMatrix[i][k] * other.adjacencyMatrix[k][j];
-                }
-            }
-        }
+        result.countStatistics();
         return result;
     }
 
-    Graph Graph::operator/(int scalar) const
+    Graph &Graph::operator/=(int scalar)
     {
-        if (scalar == 0)
-        {
-            throw std::invalid_argument("Division by zero is not allowed.");
-        }
-        Graph result = *this;
-        for (auto &row : result.adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                value /= scalar;
-            }
-        }
-        return result;
+        return *this = *this / scalar;
     }
 
-    Graph &Graph::operator/=(int scalar)
+    bool Graph::operator==(const Graph &other) const
     {
-        if (scalar == 0)
+        // Equal graphs have equal statistics, so a mismatch there settles it without a scan
+        if (vertices != other.vertices || getEdgeCount() != other.getEdgeCount() || getTotalWeight() != other.getTotalWeight())
         {
-            throw std::invalid_argument("Division by zero is not allowed.");
+            return false;
         }
-        for (auto &row : adjacencyMatrix)
+        if (dense && other.dense)
         {
-            for (auto &value : row)
-            {
-                value /= scalar;
-            }
+            // Copies that share a matrix are equal without comparing it
+            return adjacencyMatrix == other.adjacencyMatrix || *adjacencyMatrix == *other.adjacencyMatrix;
         }
-        return *this;
-    }
-
-    bool Graph::operator==(const Graph &other) const
-    {
-        return adjacencyMatrix == other.adjacencyMatrix;
+        return getCsr() == other.getCsr();
     }
 
     bool Graph::operator!=(const Graph &other) const
@@ -242,31 +251,43 @@ namespace ariel
 
     bool Graph::operator>(const Graph &other) const
     {
+        requireDense();
+        other.requireDense();
         if (vertices != other.vertices)
         {
             throw std::invalid_argument("Graphs must be of the same size to compare.");
         }
 
-        int thisEdges = 0;
-        int otherEdges = 0;
-
-        for (std::vector<std::vector<int>>::size_type i = 0; i < adjacencyMatrix.size(); ++i)
+        // The first cell, in row-major order, that is an edge in only one graph decides. An edgeless
+        // graph decides at once, and rows that are empty in both are skipped.
+        if (getEdgeCount() == 0 || other.getEdgeCount() == 0)
         {
-            for (std::vector<int>::size_type j = 0; j < adjacencyMatrix[i].size(); ++j)
+            return getEdgeCount() != 0;
+        }
+        const std::vector<int> &outDegrees = statistics->outDegrees;
+        const std::vector<int> &otherOutDegrees = other.statistics->outDegrees;
+        for (std::size_t i = 0; i < adjacencyMatrix->size(); ++i)
+        {
+            if (outDegrees[i] == 0 && otherOutDegrees[i] == 0)
             {
-                if (adjacencyMatrix[i][j] != 0 && other.adjacencyMatrix[i][j] == 0)
+                continue;
+            }
+            const int *row = adjacencyMatrix->rowData(i);
+            const int *otherRow = other.adjacencyMatrix->rowData(i);
+            for (std::size_t j = 0; j < adjacencyMatrix->size(); ++j)
+            {
+                if (row[j] != 0 && otherRow[j] == 0)
                 {
                     return true;
                 }
-                else if (adjacencyMatrix[i][j] == 0 && other.adjacencyMatrix[i][j] != 0)
+                else if (row[j] == 0 && otherRow[j] != 0)
                 {
                     return false;
                 }
-                thisEdges += adjacencyMatrix[i][j];
-                otherEdges += other.adjacencyMatrix[i][j];
             }
         }
-        return thisEdges > otherEdges;
+        // Same edges in both: the heavier graph is greater
+        return getTotalWeight() > other.getTotalWeight();
     }
 
     bool Graph::operator<(const Graph &other) const
@@ -286,14 +307,7 @@ namespace ariel
 
     Graph &Graph::operator++()
     {
-        for (auto &row : adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                ++value;
-            }
-        }
-        return *this;
+        return *this = GraphOffset<Graph>(*this, 1);
     }
 
     Graph Graph::operator++(int)
@@ -305,14 +319,7 @@ namespace ariel
 
     Graph &Graph::operator--()
     {
-        for (auto &row : adjacencyMatrix)
-        {
-            for (auto &value : row)
-            {
-                --value;
-            }
-        }
-        return *this;
+        return *this = GraphOffset<Graph>(*this, -1);
     }
 
     Graph Graph::operator--(int)
@@ -324,8 +331,9 @@ namespace ariel
 
     std::ostream &operator<<(std::ostream &os, const Graph &g)
     {
-        for (const auto &row : g.adjacencyMatrix)
+        for (int u = 0; u < g.vertices; ++u)
         {
+            const std::vector<int> row = g.getRow(u);
             os << "[";
             for (std::vector<int>::size_type i = 0; i < row.size(); ++i)
             {
@@ -2,33 +2,70 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include "BasicGraph.hpp"
+#include "DenseMatrix.hpp"
+#include "GraphExpression.hpp"
+#include "ThreadPool.hpp"
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace ariel
 {
 
-    class Graph
+    // The int graph, ariel::Graph: BasicGraph's interface over dense (aligned matrix) or sparse (CSR)
+    // storage, which all the tuned kernels work on.
+    // Copies share the matrix and everything derived from it, so copying is O(1). Mutating a graph
+    // that shares its matrix writes a new one, leaving the other copies untouched.
+    template <>
+    class BasicGraph<int> : public GraphExpression<BasicGraph<int>>
     {
     public:
-        Graph();
+        typedef int Weight;
+        typedef long long WeightSum;
+
+        BasicGraph();
+        // Evaluates an expression of the element-wise operators (see GraphExpression.hpp) in one pass
+        template <typename E>
+        BasicGraph(const GraphExpression<E> &expression);
+        template <typename E>
+        Graph &operator=(const GraphExpression<E> &expression);
+
         void loadGraph(const std::vector<std::vector<int>> &graph);
+        void loadGraph(int numVertices, const std::vector<Edge> &edges);
         void printGraph() const;
         bool isValidGraph(const std::vector<std::vector<int>> &graph) const;
         int getVertices() const { return vertices; }
         std::string toString() const;
-        const std::vector<std::vector<int>> &getAdjacencyMatrix() const { return adjacencyMatrix; }
+        // Rows are contiguous views into one aligned buffer; adjacencyMatrix[u][v] indexing still works
+        const DenseMatrix &getAdjacencyMatrix() const { return *adjacencyMatrix; }
+
+        // A graph loaded from an edge list keeps only the sparse (CSR) representation, so the matrix
+        // operators below are only available on graphs loaded from an adjacency matrix.
+        bool isDense() const { return dense; }
+        const CsrAdjacency &getCsr() const;
+        const CsrAdjacency &getReverseCsr() const;
+        const BitAdjacency &getBitAdjacency() const;
+
+        // Changes whenever the graph is loaded or modified. Versions are drawn from one global counter,
+        // so two graphs share a version only if one is an unmodified copy of the other.
+        std::uint64_t getVersion() const { return version; }
 
+        // Kept up to date by loading and by every operator, so reading them is O(1). A self-loop counts
+        // toward both degrees of its vertex.
+        std::size_t getEdgeCount() const { return statistics->edgeCount; }
+        int getOutDegree(int u) const { return statistics->outDegrees[checkedVertex(u)]; }
+        int getInDegree(int v) const { return statistics->inDegrees[checkedVertex(v)]; }
+        long long getTotalWeight() const { return statistics->totalWeight; }
+
+        // Binary + and -, unary - and scalar * and / are the expression templates in GraphExpression.hpp
         Graph &operator+=(const Graph &other);
         Graph &operator-=(const Graph &other);
-        Graph operator+(const Graph &other) const;
-        Graph operator-(const Graph &other) const;
         Graph operator+() const;
-        Graph operator-() const;
         Graph &operator*=(int scalar);
-        Graph operator/(int scalar) const;
         Graph &operator/=(int scalar);
-        Graph operator*(int scalar) const;
         Graph operator*(const Graph &other) const;
 
         bool operator==(const Graph &other) const;
@@ -45,11 +82,221 @@ namespace ariel
 
         friend std::ostream &operator<<(std::ostream &os, const Graph &g);
 
+        // Leaf of the expression templates
+        std::size_t size() const { return static_cast<std::size_t>(vertices); }
+        void validate() const { requireDense(); }
+        int cell(std::size_t k) const { return adjacencyMatrix->data()[k]; }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(adjacencyMatrix->data() + k));
+        }
+#endif
+
     private:
-        std::vector<std::vector<int>> adjacencyMatrix;
+        struct Statistics
+        {
+            explicit Statistics(std::size_t n) : edgeCount(0), outDegrees(n, 0), inDegrees(n, 0), totalWeight(0) {}
+
+            void addCell(std::size_t i, std::size_t j, int value)
+            {
+                totalWeight += value;
+                if (value != 0)
+                {
+                    ++outDegrees[i];
+                    ++inDegrees[j];
+                    ++edgeCount;
+                }
+            }
+
+            // Adds the counts of a disjoint set of rows
+            void merge(const Statistics &rows)
+            {
+                edgeCount += rows.edgeCount;
+                totalWeight += rows.totalWeight;
+                for (std::size_t v = 0; v < outDegrees.size(); ++v)
+                {
+                    outDegrees[v] += rows.outDegrees[v];
+                    inDegrees[v] += rows.inDegrees[v];
+                }
+            }
+
+            std::size_t edgeCount;
+            std::vector<int> outDegrees;
+            std::vector<int> inDegrees;
+            long long totalWeight;
+        };
+
+        void requireDense() const;
+        // Overwrites the graph with the expression's cells and recounts the statistics in the same pass.
+        // The cells go into this graph's own matrix only if no other graph shares it; then the graph
+        // itself is the only operand that can read that matrix, and every cell is read before it is
+        // written. Otherwise they go into a new matrix. Large matrices are split into row ranges over
+        // the shared thread pool, each counted on its own and merged at the end.
+        template <typename E>
+        void assign(const E &expression);
+        // Evaluates rows [first, last) of the expression into target and adds their counts to counted
+        template <typename E>
+        static void evaluateRows(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted);
+        template <typename E>
+        static void evaluateScalar(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted);
+#if ARIEL_X86_DISPATCH
+        template <typename E>
+        ARIEL_TARGET_AVX2 static void evaluateAvx2(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted);
+#endif
+
+        // Element-wise passes over fewer cells than this stay on the calling thread
+        static const std::size_t PARALLEL_CELLS = 1 << 18;
+        void invalidateCaches();
+        std::size_t checkedVertex(int u) const;
+        // Counts the statistics from scratch, for freshly loaded graphs
+        void countStatistics();
+        std::vector<int> getRow(int u) const;
+
+        std::shared_ptr<DenseMatrix> adjacencyMatrix;
+        std::shared_ptr<const Statistics> statistics;
         int vertices;
+        bool dense;
+        std::uint64_t version;
+
+        // Shared with unmodified copies along with the matrix; see AdjacencyViews
+        std::shared_ptr<AdjacencyViews<int>> views;
     };
 
+    template <typename E>
+    Graph::BasicGraph(const GraphExpression<E> &expression) : BasicGraph()
+    {
+        assign(expression.self());
+    }
+
+    template <typename E>
+    Graph &Graph::operator=(const GraphExpression<E> &expression)
+    {
+        assign(expression.self());
+        return *this;
+    }
+
+    template <typename E>
+    void Graph::assign(const E &expression)
+    {
+        std::size_t n = expression.size();
+        bool inPlace = dense && adjacencyMatrix.use_count() == 1 && adjacencyMatrix->size() == n;
+        std::shared_ptr<DenseMatrix> target = inPlace ? adjacencyMatrix : std::make_shared<DenseMatrix>(n);
+        std::shared_ptr<Statistics> counted = std::make_shared<Statistics>(n);
+        if (n * n < PARALLEL_CELLS)
+        {
+            evaluateRows(expression, *target, 0, n, *counted);
+        }
+        else
+        {
+            DenseMatrix &cells = *target;
+            Statistics &total = *counted;
+            std::mutex mergeMutex;
+            ThreadPool::shared().parallelFor(0, n, PARALLEL_CELLS / 4 / n + 1, [&](std::size_t first, std::size_t last)
+                                             {
+                                                 Statistics rows(n);
+                                                 evaluateRows(expression, cells, first, last, rows);
+                                                 std::lock_guard<std::mutex> lock(mergeMutex);
+                                                 total.merge(rows);
+                                             });
+        }
+        adjacencyMatrix = target;
+        statistics = counted;
+        vertices = static_cast<int>(n);
+        dense = true;
+        invalidateCaches();
+    }
+
+    template <typename E>
+    void Graph::evaluateRows(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted)
+    {
+#if ARIEL_X86_DISPATCH
+        if (CpuFeatures::hasAvx2())
+        {
+            evaluateAvx2(expression, target, first, last, counted);
+            return;
+        }
+#endif
+        evaluateScalar(expression, target, first, last, counted);
+    }
+
+    template <typename E>
+    void Graph::evaluateScalar(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted)
+    {
+        std::size_t n = target.size();
+        for (std::size_t i = first; i < last; ++i)
+        {
+            int *row = target.rowData(i);
+            std::size_t base = i * target.stride();
+            int degree = 0;
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                int value = expression.cell(base + j);
+                row[j] = value;
+                int edge = value != 0 ? 1 : 0;
+                degree += edge;
+                counted.inDegrees[j] += edge;
+                counted.totalWeight += value;
+            }
+            counted.outDegrees[i] = degree;
+            counted.edgeCount += static_cast<std::size_t>(degree);
+        }
+    }
+
+#if ARIEL_X86_DISPATCH
+    template <typename E>
+    ARIEL_TARGET_AVX2 void Graph::evaluateAvx2(const E &expression, DenseMatrix &target, std::size_t first, std::size_t last, Statistics &counted)
+    {
+        std::size_t n = target.size();
+        int *inDegree = counted.inDegrees.data();
+        for (std::size_t i = first; i < last; ++i)
+        {
+            int *row = target.rowData(i);
+            std::size_t base = i * target.stride();
+            // Lane-wise edge counts and 64-bit weight sums, folded once per row
+            __m256i degrees = _mm256_setzero_si256();
+            __m256i weights = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8)
+            {
+                __m256i values = expression.packet(base + j);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + j), values);
+                // All ones in the lanes holding an edge; subtracting it adds one
+                __m256i edges = _mm256_xor_si256(_mm256_cmpeq_epi32(values, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+                degrees = _mm256_sub_epi32(degrees, edges);
+                __m256i *columns = reinterpret_cast<__m256i *>(inDegree + j);
+                _mm256_storeu_si256(columns, _mm256_sub_epi32(_mm256_loadu_si256(columns), edges));
+                weights = _mm256_add_epi64(weights, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+                weights = _mm256_add_epi64(weights, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+            }
+            alignas(32) int degreeLanes[8];
+            alignas(32) long long weightLanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(degreeLanes), degrees);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(weightLanes), weights);
+            int degree = 0;
+            for (int lane : degreeLanes)
+            {
+                degree += lane;
+            }
+            for (long long lane : weightLanes)
+            {
+                counted.totalWeight += lane;
+            }
+            for (; j < n; ++j)
+            {
+                int value = expression.cell(base + j);
+                row[j] = value;
+                int edge = value != 0 ? 1 : 0;
+                degree += edge;
+                inDegree[j] += edge;
+                counted.totalWeight += value;
+            }
+            counted.outDegrees[i] = degree;
+            counted.edgeCount += static_cast<std::size_t>(degree);
+        }
+    }
+#endif
+
 }
 
 #endif
\ No newline at end of file
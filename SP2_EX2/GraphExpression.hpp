@@ -0,0 +1,203 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef GRAPH_EXPRESSION_HPP
+#define GRAPH_EXPRESSION_HPP
+
+#include "CpuFeatures.hpp"
+#include "GraphFwd.hpp"
+#include "IntDivisor.hpp"
+#include <cstddef>
+#include <stdexcept>
+
+#if ARIEL_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace ariel
+{
+
+    // Expression templates for the element-wise Graph operators. g1 + g2 - g3 * 2 builds a small tree
+    // of nodes instead of a matrix per operator; assigning it to a Graph evaluates every cell in one
+    // pass with no intermediate matrices. Operands are checked when a node is built, so errors still
+    // surface at the operator. Nodes refer to their Graph leaves, so evaluate an expression before
+    // its operands go away (do not keep one in an auto variable).
+    //
+    // Every expression E offers size(), validate(), cell(k) and, on x86, packet(k) with the 8 cells
+    // from k on; k is an offset into the padded row-major buffer, which all same-size graphs share.
+    template <typename E>
+    class GraphExpression
+    {
+    public:
+        const E &self() const { return static_cast<const E &>(*this); }
+    };
+
+    // Nodes hold Graph leaves by reference and other nodes, which are a few words each, by value
+    template <typename E>
+    struct GraphOperand
+    {
+        typedef const E type;
+    };
+
+    template <>
+    struct GraphOperand<Graph>
+    {
+        typedef const Graph &type;
+    };
+
+    template <typename L, typename R>
+    class GraphSum : public GraphExpression<GraphSum<L, R>>
+    {
+    public:
+        GraphSum(const L &left, const R &right) : left(left), right(right)
+        {
+            left.validate();
+            right.validate();
+            if (left.size() != right.size())
+            {
+                throw std::invalid_argument("Graphs must be of the same size to add.");
+            }
+        }
+
+        std::size_t size() const { return left.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return left.cell(k) + right.cell(k); }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return _mm256_add_epi32(left.packet(k), right.packet(k)); }
+#endif
+
+    private:
+        typename GraphOperand<L>::type left;
+        typename GraphOperand<R>::type right;
+    };
+
+    template <typename L, typename R>
+    class GraphDifference : public GraphExpression<GraphDifference<L, R>>
+    {
+    public:
+        GraphDifference(const L &left, const R &right) : left(left), right(right)
+        {
+            left.validate();
+            right.validate();
+            if (left.size() != right.size())
+            {
+                throw std::invalid_argument("Graphs must be of the same size to subtract.");
+            }
+        }
+
+        std::size_t size() const { return left.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return left.cell(k) - right.cell(k); }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return _mm256_sub_epi32(left.packet(k), right.packet(k)); }
+#endif
+
+    private:
+        typename GraphOperand<L>::type left;
+        typename GraphOperand<R>::type right;
+    };
+
+    template <typename E>
+    class GraphNegation : public GraphExpression<GraphNegation<E>>
+    {
+    public:
+        explicit GraphNegation(const E &operand) : operand(operand) { operand.validate(); }
+
+        std::size_t size() const { return operand.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return -operand.cell(k); }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return _mm256_sub_epi32(_mm256_setzero_si256(), operand.packet(k)); }
+#endif
+
+    private:
+        typename GraphOperand<E>::type operand;
+    };
+
+    template <typename E>
+    class GraphScaled : public GraphExpression<GraphScaled<E>>
+    {
+    public:
+        GraphScaled(const E &operand, int scalar) : operand(operand), scalar(scalar) { operand.validate(); }
+
+        std::size_t size() const { return operand.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return operand.cell(k) * scalar; }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return _mm256_mullo_epi32(operand.packet(k), _mm256_set1_epi32(scalar)); }
+#endif
+
+    private:
+        typename GraphOperand<E>::type operand;
+        int scalar;
+    };
+
+    // Divides by a precomputed reciprocal rather than one idiv per cell; see IntDivisor
+    template <typename E>
+    class GraphQuotient : public GraphExpression<GraphQuotient<E>>
+    {
+    public:
+        GraphQuotient(const E &operand, int divisor) : operand(operand), divisor(divisor) { operand.validate(); }
+
+        std::size_t size() const { return operand.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return divisor.divide(operand.cell(k)); }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return divisor.divide(operand.packet(k)); }
+#endif
+
+    private:
+        typename GraphOperand<E>::type operand;
+        IntDivisor divisor;
+    };
+
+    // Adds a constant to every cell; backs ++ and -- rather than a public operator
+    template <typename E>
+    class GraphOffset : public GraphExpression<GraphOffset<E>>
+    {
+    public:
+        GraphOffset(const E &operand, int offset) : operand(operand), offset(offset) { operand.validate(); }
+
+        std::size_t size() const { return operand.size(); }
+        void validate() const {}
+        int cell(std::size_t k) const { return operand.cell(k) + offset; }
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i packet(std::size_t k) const { return _mm256_add_epi32(operand.packet(k), _mm256_set1_epi32(offset)); }
+#endif
+
+    private:
+        typename GraphOperand<E>::type operand;
+        int offset;
+    };
+
+    template <typename L, typename R>
+    GraphSum<L, R> operator+(const GraphExpression<L> &left, const GraphExpression<R> &right)
+    {
+        return GraphSum<L, R>(left.self(), right.self());
+    }
+
+    template <typename L, typename R>
+    GraphDifference<L, R> operator-(const GraphExpression<L> &left, const GraphExpression<R> &right)
+    {
+        return GraphDifference<L, R>(left.self(), right.self());
+    }
+
+    template <typename E>
+    GraphNegation<E> operator-(const GraphExpression<E> &operand)
+    {
+        return GraphNegation<E>(operand.self());
+    }
+
+    template <typename E>
+    GraphScaled<E> operator*(const GraphExpression<E> &operand, int scalar)
+    {
+        return GraphScaled<E>(operand.self(), scalar);
+    }
+
+    template <typename E>
+    GraphQuotient<E> operator/(const GraphExpression<E> &operand, int divisor)
+    {
+        return GraphQuotient<E>(operand.self(), divisor);
+    }
+
+}
+
+#endif
@@ -0,0 +1,16 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef GRAPH_FWD_HPP
+#define GRAPH_FWD_HPP
+
+namespace ariel
+{
+
+    // Graphs are templates over the weight type; ariel::Graph is the int one, which the tuned kernels
+    // (CSR, dense AVX2 passes, expression templates, caches) are written for. See Graph.hpp.
+    template <typename W>
+    class BasicGraph;
+    typedef BasicGraph<int> Graph;
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "IntDivisor.hpp"
+#include <stdexcept>
+
+namespace ariel
+{
+
+    IntDivisor::IntDivisor(int divisor) : divisor(divisor), magic(0), adjust(0), shift(0), unit(divisor == 1 || divisor == -1)
+    {
+        if (divisor == 0)
+        {
+            throw std::invalid_argument("Division by zero is not allowed.");
+        }
+        if (unit)
+        {
+            return;
+        }
+
+        // Smallest p >= 32 for which 2^p / |d|, rounded up, is a magic number (Hacker's Delight 10-1)
+        const unsigned two31 = 0x80000000u;
+        unsigned ad = divisor < 0 ? 0u - static_cast<unsigned>(divisor) : static_cast<unsigned>(divisor);
+        unsigned t = two31 + (static_cast<unsigned>(divisor) >> 31);
+        unsigned anc = t - 1 - t % ad; // |nc|, the largest dividend with nc mod d = d - 1
+        int p = 31;
+        unsigned q1 = two31 / anc, r1 = two31 - q1 * anc;
+        unsigned q2 = two31 / ad, r2 = two31 - q2 * ad;
+        unsigned delta;
+        do
+        {
+            ++p;
+            q1 *= 2;
+            r1 *= 2;
+            if (r1 >= anc)
+            {
+                ++q1;
+                r1 -= anc;
+            }
+            q2 *= 2;
+            r2 *= 2;
+            if (r2 >= ad)
+            {
+                ++q2;
+                r2 -= ad;
+            }
+            delta = ad - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+
+        unsigned m = q2 + 1;
+        magic = static_cast<int>(divisor < 0 ? 0u - m : m);
+        shift = p - 32;
+        if (divisor > 0 && magic < 0)
+        {
+            adjust = 1;
+        }
+        else if (divisor < 0 && magic > 0)
+        {
+            adjust = -1;
+        }
+    }
+
+}
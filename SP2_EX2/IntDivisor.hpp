@@ -0,0 +1,81 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef INT_DIVISOR_HPP
+#define INT_DIVISOR_HPP
+
+#include "CpuFeatures.hpp"
+
+#if ARIEL_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace ariel
+{
+
+    // Division by one int many times over, as in libdivide: the constructor turns the divisor into a
+    // magic multiplier and shift (Hacker's Delight, ch. 10), so each quotient costs a multiply-high, a
+    // shift and a sign fix instead of an idiv, and eight lanes can be divided at once with AVX2.
+    // Quotients truncate toward zero, exactly like the / operator.
+    class IntDivisor
+    {
+    public:
+        // Throws std::invalid_argument for zero
+        explicit IntDivisor(int divisor);
+
+        int getDivisor() const { return divisor; }
+
+        int divide(int n) const
+        {
+            if (unit)
+            {
+                return divisor == 1 ? n : static_cast<int>(0u - static_cast<unsigned>(n));
+            }
+            int q = static_cast<int>((static_cast<long long>(magic) * n) >> 32);
+            // Wraps like the vector lanes do; the final quotient is exact regardless
+            if (adjust > 0)
+            {
+                q = static_cast<int>(static_cast<unsigned>(q) + static_cast<unsigned>(n));
+            }
+            else if (adjust < 0)
+            {
+                q = static_cast<int>(static_cast<unsigned>(q) - static_cast<unsigned>(n));
+            }
+            q >>= shift;
+            return q + static_cast<int>(static_cast<unsigned>(q) >> 31);
+        }
+
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 __m256i divide(__m256i n) const
+        {
+            if (unit)
+            {
+                return divisor == 1 ? n : _mm256_sub_epi32(_mm256_setzero_si256(), n);
+            }
+            // High halves of the signed 32x32 products: even lanes, then odd lanes shifted down
+            __m256i m = _mm256_set1_epi32(magic);
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(n, m), 32);
+            __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(n, 32), m);
+            __m256i q = _mm256_blend_epi32(even, odd, 0xAA);
+            if (adjust > 0)
+            {
+                q = _mm256_add_epi32(q, n);
+            }
+            else if (adjust < 0)
+            {
+                q = _mm256_sub_epi32(q, n);
+            }
+            q = _mm256_sra_epi32(q, _mm_cvtsi32_si128(shift));
+            return _mm256_add_epi32(q, _mm256_srli_epi32(q, 31));
+        }
+#endif
+
+    private:
+        int divisor;
+        int magic;
+        int adjust; // -1, 0 or 1 times the dividend added to the product's high half
+        int shift;
+        bool unit;  // divisor is 1 or -1, which have no magic number
+    };
+
+}
+
+#endif
@@ -0,0 +1,371 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "Landmarks.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    namespace
+    {
+        const Distance NONE = ShortestPathTree::UNREACHABLE;
+        const char MAGIC[8] = {'A', 'R', 'I', 'E', 'L', 'A', 'L', 'T'};
+        const std::uint32_t FORMAT_VERSION = 1;
+
+        template <typename T>
+        void writeValues(std::ofstream &out, const T *values, std::size_t count)
+        {
+            out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+        }
+
+        template <typename T>
+        void readValues(std::ifstream &in, T *values, std::size_t count)
+        {
+            in.read(reinterpret_cast<char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+            if (!in)
+            {
+                throw std::runtime_error("Landmark file is truncated.");
+            }
+        }
+    }
+
+    LandmarkIndex::LandmarkIndex(const Graph &g)
+        : graph(g), version(g.getVersion()), vertexCount(static_cast<std::size_t>(g.getVertices())), query(0),
+          forwardHeap(vertexCount), backwardHeap(vertexCount), lastSettled(0)
+    {
+        const CsrAdjacency &adjacency = g.getCsr();
+        if (ShortestPaths::hasNegativeWeights(adjacency))
+        {
+            throw std::invalid_argument("Landmarks require non-negative weights.");
+        }
+        stamp.assign(vertexCount, 0);
+        potential.resize(vertexCount);
+        forwardDistance.resize(vertexCount);
+        backwardDistance.resize(vertexCount);
+        forwardParent.resize(vertexCount);
+        backwardParent.resize(vertexCount);
+    }
+
+    LandmarkIndex::LandmarkIndex(const Graph &g, int count) : LandmarkIndex(g)
+    {
+        if (count <= 0)
+        {
+            throw std::invalid_argument("Landmark count must be positive.");
+        }
+        const CsrAdjacency &adjacency = g.getCsr();
+        std::size_t k = std::min(static_cast<std::size_t>(count), vertexCount);
+        landmarks.reserve(k);
+        from.reserve(k * vertexCount);
+
+        // Farthest-point selection: the next landmark is the vertex farthest from all chosen so far,
+        // seeded with the distances from vertex 0. Unreachable vertices count as farthest, so every
+        // part of the graph gets covered.
+        std::vector<Distance> nearest;
+        if (k > 0)
+        {
+            nearest = ShortestPaths::dijkstra(adjacency, 0).distance;
+        }
+        for (std::size_t l = 0; l < k; ++l)
+        {
+            int chosen = static_cast<int>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+            landmarks.push_back(chosen);
+            ShortestPathTree tree = ShortestPaths::dijkstra(adjacency, chosen);
+            from.insert(from.end(), tree.distance.begin(), tree.distance.end());
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                nearest[v] = std::min(nearest[v], tree.distance[v]);
+            }
+            nearest[static_cast<std::size_t>(chosen)] = -1;
+        }
+
+        // Distances to each landmark are distances from it in the reverse graph
+        const CsrAdjacency &reverse = g.getReverseCsr();
+        to.resize(k * vertexCount);
+        ThreadPool::shared().parallelFor(0, k, 1, [&](std::size_t first, std::size_t last)
+                                         {
+                                             for (std::size_t l = first; l < last; ++l)
+                                             {
+                                                 ShortestPathTree tree = ShortestPaths::dijkstra(reverse, landmarks[l]);
+                                                 std::copy(tree.distance.begin(), tree.distance.end(), to.begin() + static_cast<std::ptrdiff_t>(l * vertexCount));
+                                             }
+                                         });
+    }
+
+    std::uint64_t LandmarkIndex::fingerprint(const CsrAdjacency &adjacency)
+    {
+        // 64-bit FNV-1a over the vertex count and the CSR arrays
+        std::uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](std::uint64_t value)
+        {
+            for (int byte = 0; byte < 8; ++byte)
+            {
+                hash = (hash ^ ((value >> (8 * byte)) & 0xff)) * 1099511628211ULL;
+            }
+        };
+        mix(static_cast<std::uint64_t>(adjacency.getVertices()));
+        for (std::size_t offset : adjacency.getOffsets())
+        {
+            mix(offset);
+        }
+        for (int target : adjacency.getTargets())
+        {
+            mix(static_cast<std::uint64_t>(static_cast<std::uint32_t>(target)));
+        }
+        for (int weight : adjacency.getWeights())
+        {
+            mix(static_cast<std::uint64_t>(static_cast<std::uint32_t>(weight)));
+        }
+        return hash;
+    }
+
+    void LandmarkIndex::save(const std::string &file) const
+    {
+        std::ofstream out(file.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot open landmark file for writing.");
+        }
+        std::uint64_t header[3] = {vertexCount, landmarks.size(), fingerprint(graph.getCsr())};
+        writeValues(out, MAGIC, sizeof(MAGIC));
+        writeValues(out, &FORMAT_VERSION, 1);
+        writeValues(out, header, 3);
+        writeValues(out, landmarks.data(), landmarks.size());
+        writeValues(out, from.data(), from.size());
+        writeValues(out, to.data(), to.size());
+        if (!out.flush())
+        {
+            throw std::runtime_error("Cannot write landmark file.");
+        }
+    }
+
+    LandmarkIndex LandmarkIndex::load(const Graph &g, const std::string &file)
+    {
+        std::ifstream in(file.c_str(), std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("Cannot open landmark file.");
+        }
+        LandmarkIndex index(g);
+        char magic[sizeof(MAGIC)];
+        std::uint32_t format = 0;
+        std::uint64_t header[3];
+        readValues(in, magic, sizeof(magic));
+        readValues(in, &format, 1);
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || format != FORMAT_VERSION)
+        {
+            throw std::runtime_error("Not a landmark file.");
+        }
+        readValues(in, header, 3);
+        if (header[0] != index.vertexCount || header[1] > index.vertexCount || header[2] != fingerprint(g.getCsr()))
+        {
+            throw std::invalid_argument("Landmark file does not match the graph.");
+        }
+        std::size_t k = static_cast<std::size_t>(header[1]);
+        index.landmarks.resize(k);
+        index.from.resize(k * index.vertexCount);
+        index.to.resize(k * index.vertexCount);
+        readValues(in, index.landmarks.data(), k);
+        readValues(in, index.from.data(), index.from.size());
+        readValues(in, index.to.data(), index.to.size());
+        return index;
+    }
+
+    Distance LandmarkIndex::boundTo(int v, int target) const
+    {
+        Distance bound = 0;
+        for (std::size_t l = 0; l < landmarks.size(); ++l)
+        {
+            // d(v, t) >= d(v, L) - d(t, L); if t reaches L but v does not, v cannot reach t
+            if (toLandmark(l, target) != NONE)
+            {
+                if (toLandmark(l, v) == NONE)
+                {
+                    return NONE;
+                }
+                bound = std::max(bound, toLandmark(l, v) - toLandmark(l, target));
+            }
+            // d(v, t) >= d(L, t) - d(L, v)
+            if (fromLandmark(l, target) != NONE && fromLandmark(l, v) != NONE)
+            {
+                bound = std::max(bound, fromLandmark(l, target) - fromLandmark(l, v));
+            }
+        }
+        return bound;
+    }
+
+    Distance LandmarkIndex::boundFrom(int source, int v) const
+    {
+        Distance bound = 0;
+        for (std::size_t l = 0; l < landmarks.size(); ++l)
+        {
+            // d(s, v) >= d(L, v) - d(L, s); if L reaches s but not v, s cannot reach v
+            if (fromLandmark(l, source) != NONE)
+            {
+                if (fromLandmark(l, v) == NONE)
+                {
+                    return NONE;
+                }
+                bound = std::max(bound, fromLandmark(l, v) - fromLandmark(l, source));
+            }
+            // d(s, v) >= d(s, L) - d(v, L)
+            if (toLandmark(l, source) != NONE && toLandmark(l, v) != NONE)
+            {
+                bound = std::max(bound, toLandmark(l, source) - toLandmark(l, v));
+            }
+        }
+        return bound;
+    }
+
+    void LandmarkIndex::checkQuery(int from, int to) const
+    {
+        if (version != graph.getVersion())
+        {
+            throw std::logic_error("Landmark tables are out of date.");
+        }
+        if (from < 0 || to < 0 || static_cast<std::size_t>(from) >= vertexCount || static_cast<std::size_t>(to) >= vertexCount)
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+    }
+
+    Distance LandmarkIndex::lowerBound(int from, int to) const
+    {
+        checkQuery(from, to);
+        return boundTo(from, to);
+    }
+
+    int LandmarkIndex::search(int source, int target, Distance &best)
+    {
+        const CsrAdjacency &adjacency = graph.getCsr();
+        const CsrAdjacency &reverse = graph.getReverseCsr();
+        if (++query == 0)
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            query = 1;
+        }
+        forwardHeap.clear();
+        backwardHeap.clear();
+        lastSettled = 0;
+        best = NONE;
+
+        // First touch of a vertex in this query. The forward search uses the average potential
+        // (bound to target - bound from source) / 2, the backward search its negation; keys are doubled
+        // to stay integral. A vertex that provably lies on no source-target path is marked NONE.
+        auto touch = [&](int v)
+        {
+            std::size_t sv = static_cast<std::size_t>(v);
+            if (stamp[sv] == query)
+            {
+                return;
+            }
+            stamp[sv] = query;
+            forwardDistance[sv] = backwardDistance[sv] = NONE;
+            forwardParent[sv] = backwardParent[sv] = -1;
+            Distance ahead = boundTo(v, target);
+            Distance behind = boundFrom(source, v);
+            potential[sv] = ahead == NONE || behind == NONE ? NONE : ahead - behind;
+        };
+
+        touch(source);
+        touch(target);
+        if (potential[static_cast<std::size_t>(source)] == NONE || potential[static_cast<std::size_t>(target)] == NONE)
+        {
+            return -1;
+        }
+        forwardDistance[static_cast<std::size_t>(source)] = 0;
+        backwardDistance[static_cast<std::size_t>(target)] = 0;
+        forwardHeap.push(source, potential[static_cast<std::size_t>(source)]);
+        backwardHeap.push(target, -potential[static_cast<std::size_t>(target)]);
+
+        int meet = -1;
+        while (!forwardHeap.empty() && !backwardHeap.empty())
+        {
+            Distance forwardKey = forwardHeap.key(forwardHeap.top());
+            Distance backwardKey = backwardHeap.key(backwardHeap.top());
+            // Both searches run Dijkstra on the same reduced graph, so the usual bidirectional rule holds
+            if (best != NONE && forwardKey + backwardKey >= 2 * best)
+            {
+                break;
+            }
+
+            bool forward = forwardKey <= backwardKey;
+            PairingHeap<Distance> &heap = forward ? forwardHeap : backwardHeap;
+            const CsrAdjacency &edges = forward ? adjacency : reverse;
+            std::vector<Distance> &distance = forward ? forwardDistance : backwardDistance;
+            std::vector<Distance> &other = forward ? backwardDistance : forwardDistance;
+            std::vector<int> &parent = forward ? forwardParent : backwardParent;
+            Distance sign = forward ? 1 : -1;
+
+            int u = heap.popMin();
+            ++lastSettled;
+            Distance du = distance[static_cast<std::size_t>(u)];
+            for (std::size_t e = edges.rowBegin(u); e < edges.rowEnd(u); ++e)
+            {
+                int v = edges.target(e);
+                touch(v);
+                std::size_t sv = static_cast<std::size_t>(v);
+                Distance candidate = du + edges.weight(e);
+                if (potential[sv] == NONE || candidate >= distance[sv])
+                {
+                    continue;
+                }
+                Distance key = 2 * candidate + sign * potential[sv];
+                if (heap.contains(v))
+                {
+                    heap.decreaseKey(v, key);
+                }
+                else
+                {
+                    heap.push(v, key);
+                }
+                distance[sv] = candidate;
+                parent[sv] = u;
+                if (other[sv] != NONE && (best == NONE || candidate + other[sv] < best))
+                {
+                    best = candidate + other[sv];
+                    meet = v;
+                }
+            }
+        }
+        if (source == target)
+        {
+            best = 0;
+            meet = source;
+        }
+        return meet;
+    }
+
+    Distance LandmarkIndex::distance(int from, int to)
+    {
+        checkQuery(from, to);
+        Distance best;
+        search(from, to, best);
+        return best;
+    }
+
+    std::vector<int> LandmarkIndex::path(int from, int to)
+    {
+        checkQuery(from, to);
+        Distance best;
+        int meet = search(from, to, best);
+        std::vector<int> vertices;
+        if (meet == -1)
+        {
+            return vertices;
+        }
+        for (int v = meet; v != -1; v = forwardParent[static_cast<std::size_t>(v)])
+        {
+            vertices.push_back(v);
+        }
+        std::reverse(vertices.begin(), vertices.end());
+        for (int v = backwardParent[static_cast<std::size_t>(meet)]; v != -1; v = backwardParent[static_cast<std::size_t>(v)])
+        {
+            vertices.push_back(v);
+        }
+        return vertices;
+    }
+
+}
@@ -0,0 +1,77 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include "PairingHeap.hpp"
+#include "ShortestPaths.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ariel
+{
+
+    // ALT point-to-point queries (A*, landmarks, triangle inequality) on a static graph with
+    // non-negative weights. Preprocessing stores the distances from and to k landmarks. Their
+    // differences bound d(v, t) from below, and a bidirectional A* guided by these bounds settles
+    // far fewer vertices than Dijkstra. Queries reuse internal buffers, so an index serves one thread
+    // at a time, and it must be rebuilt or reloaded once the graph changes.
+    class LandmarkIndex
+    {
+    public:
+        // Picks up to count landmarks, each the vertex farthest from those already chosen
+        LandmarkIndex(const Graph &g, int count);
+
+        // Writes the tables in a binary file, and reads them back for the same graph; load throws if
+        // the file was written for a graph with different edges
+        void save(const std::string &file) const;
+        static LandmarkIndex load(const Graph &g, const std::string &file);
+
+        const std::vector<int> &getLandmarks() const { return landmarks; }
+
+        // Lower bound on d(from, to) from the landmark tables; UNREACHABLE if no path can exist
+        Distance lowerBound(int from, int to) const;
+
+        // ShortestPathTree::UNREACHABLE if there is no path
+        Distance distance(int from, int to);
+        // Vertices from `from` to `to`, or an empty vector if there is no path
+        std::vector<int> path(int from, int to);
+
+        // Vertices settled by the last query, both directions together
+        std::size_t getLastSettled() const { return lastSettled; }
+
+    private:
+        explicit LandmarkIndex(const Graph &g);
+
+        void allocate();
+        Distance fromLandmark(std::size_t l, int v) const { return from[l * vertexCount + static_cast<std::size_t>(v)]; }
+        Distance toLandmark(std::size_t l, int v) const { return to[l * vertexCount + static_cast<std::size_t>(v)]; }
+        // Bounds on d(source, v) and on d(v, target) from the landmark tables
+        Distance boundFrom(int source, int v) const;
+        Distance boundTo(int v, int target) const;
+        void checkQuery(int from, int to) const;
+        // Bidirectional A*; returns the meeting vertex or -1, and the distance in best
+        int search(int source, int target, Distance &best);
+
+        static std::uint64_t fingerprint(const CsrAdjacency &adjacency);
+
+        const Graph &graph;
+        std::uint64_t version;
+        std::size_t vertexCount;
+        std::vector<int> landmarks;
+        std::vector<Distance> from; // from[l * V + v] = d(landmark l, v)
+        std::vector<Distance> to;   // to[l * V + v] = d(v, landmark l)
+
+        // Per-query state, valid for vertices whose stamp equals the current query
+        std::vector<unsigned> stamp;
+        unsigned query;
+        std::vector<Distance> potential; // 2 * A* potential of the forward search
+        std::vector<Distance> forwardDistance, backwardDistance;
+        std::vector<int> forwardParent, backwardParent;
+        PairingHeap<Distance> forwardHeap, backwardHeap;
+        std::size_t lastSettled;
+    };
+
+}
+
+#endif
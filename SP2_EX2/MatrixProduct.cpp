@@ -0,0 +1,314 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "MatrixProduct.hpp"
+#include "Avx2Ops.hpp"
+#include "CpuFeatures.hpp"
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+namespace ariel
+{
+
+    namespace
+    {
+        const std::size_t PANEL_WIDTH = 16; // columns per packed panel: two AVX2 registers
+        const std::size_t ROW_BLOCK = 64;   // rows of the result per parallel task
+        const std::size_t DEPTH_BLOCK = 256; // k values per pass, keeps a panel slice in L1
+
+        // Semiring policies: zero() is the additive identity, skip(a) says that a annihilates every
+        // product a (x) b so the whole k step can be skipped, combine(acc, a, b) is acc (+) (a (x) b).
+        struct PlusTimes
+        {
+            static int zero() { return 0; }
+            static bool skip(int a) { return a == 0; }
+            static int combine(int acc, int a, int b)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(acc) + static_cast<std::uint32_t>(a) * static_cast<std::uint32_t>(b));
+            }
+#if ARIEL_X86_DISPATCH
+            ARIEL_TARGET_AVX2 static __m256i combine(__m256i acc, __m256i a, __m256i b)
+            {
+                return _mm256_add_epi32(acc, _mm256_mullo_epi32(a, b));
+            }
+#endif
+        };
+
+        struct MinPlus
+        {
+            static int zero() { return MatrixProduct::INFINITE_DISTANCE; }
+            static bool skip(int a) { return a == MatrixProduct::INFINITE_DISTANCE; }
+            static int combine(int acc, int a, int b)
+            {
+                return std::min(acc, distanceAdd(a, b, MatrixProduct::INFINITE_DISTANCE));
+            }
+#if ARIEL_X86_DISPATCH
+            ARIEL_TARGET_AVX2 static __m256i combine(__m256i acc, __m256i a, __m256i b)
+            {
+                return _mm256_min_epi32(acc, avx2::distanceAdd(a, b, _mm256_set1_epi32(MatrixProduct::INFINITE_DISTANCE)));
+            }
+#endif
+        };
+
+        struct OrAnd
+        {
+            static int zero() { return 0; }
+            static bool skip(int a) { return a == 0; }
+            static int combine(int acc, int a, int b) { return (acc != 0 || (a != 0 && b != 0)) ? 1 : 0; }
+#if ARIEL_X86_DISPATCH
+            ARIEL_TARGET_AVX2 static __m256i combine(__m256i acc, __m256i a, __m256i b)
+            {
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i one = _mm256_set1_epi32(1);
+                __m256i both = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(a, zero), _mm256_cmpeq_epi32(b, zero)), one);
+                return _mm256_or_si256(acc, both);
+            }
+#endif
+        };
+
+        struct MaxMin
+        {
+            static int zero() { return MatrixProduct::NO_PATH_WIDTH; }
+            static bool skip(int a) { return a == MatrixProduct::NO_PATH_WIDTH; }
+            static int combine(int acc, int a, int b) { return std::max(acc, std::min(a, b)); }
+#if ARIEL_X86_DISPATCH
+            ARIEL_TARGET_AVX2 static __m256i combine(__m256i acc, __m256i a, __m256i b)
+            {
+                return _mm256_max_epi32(acc, _mm256_min_epi32(a, b));
+            }
+#endif
+        };
+
+        // c[r][0..16) (+)= sum over k < depth of a[r][k] (x) panel[k][0..16), for ROWS rows
+        template <typename Policy, std::size_t ROWS>
+        void tileScalar(const int *const *a, const int *panel, std::size_t depth, int *const *c)
+        {
+            for (std::size_t r = 0; r < ROWS; ++r)
+            {
+                for (std::size_t k = 0; k < depth; ++k)
+                {
+                    int x = a[r][k];
+                    if (Policy::skip(x))
+                    {
+                        continue;
+                    }
+                    const int *b = panel + k * PANEL_WIDTH;
+                    for (std::size_t j = 0; j < PANEL_WIDTH; ++j)
+                    {
+                        c[r][j] = Policy::combine(c[r][j], x, b[j]);
+                    }
+                }
+            }
+        }
+
+#if ARIEL_X86_DISPATCH
+        template <typename Policy, std::size_t ROWS>
+        ARIEL_TARGET_AVX2 void tileAvx2(const int *const *a, const int *panel, std::size_t depth, int *const *c)
+        {
+            __m256i low[ROWS];
+            __m256i high[ROWS];
+            for (std::size_t r = 0; r < ROWS; ++r)
+            {
+                low[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c[r]));
+                high[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c[r] + 8));
+            }
+            for (std::size_t k = 0; k < depth; ++k)
+            {
+                bool any = false;
+                for (std::size_t r = 0; r < ROWS; ++r)
+                {
+                    any = any || !Policy::skip(a[r][k]);
+                }
+                if (!any)
+                {
+                    continue; // adjacency matrices are mostly empty
+                }
+                __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(panel + k * PANEL_WIDTH));
+                __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(panel + k * PANEL_WIDTH + 8));
+                for (std::size_t r = 0; r < ROWS; ++r)
+                {
+                    __m256i x = _mm256_set1_epi32(a[r][k]);
+                    low[r] = Policy::combine(low[r], x, b0);
+                    high[r] = Policy::combine(high[r], x, b1);
+                }
+            }
+            for (std::size_t r = 0; r < ROWS; ++r)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(c[r]), low[r]);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(c[r] + 8), high[r]);
+            }
+        }
+#endif
+
+        template <typename Policy, std::size_t ROWS>
+        void tile(bool avx2, const int *const *a, const int *panel, std::size_t depth, int *const *c)
+        {
+#if ARIEL_X86_DISPATCH
+            if (avx2)
+            {
+                tileAvx2<Policy, ROWS>(a, panel, depth, c);
+                return;
+            }
+#endif
+            (void)avx2;
+            tileScalar<Policy, ROWS>(a, panel, depth, c);
+        }
+
+        template <typename Policy>
+        void multiplyWith(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix &result)
+        {
+            std::size_t n = a.size();
+            result = DenseMatrix(n, Policy::zero());
+            if (n == 0)
+            {
+                return;
+            }
+
+            // Pack b into column panels: panel p holds b[k][16p .. 16p + 16) for k = 0..n-1 contiguously.
+            // The stride is a multiple of 16, so there is no ragged edge; padding columns are computed
+            // like any other and reset to zero at the end.
+            std::size_t panels = b.stride() / PANEL_WIDTH;
+            std::vector<int> packed(panels * n * PANEL_WIDTH);
+            ThreadPool &pool = ThreadPool::shared();
+            pool.parallelFor(0, panels, 1, [&](std::size_t first, std::size_t last)
+                             {
+                                 for (std::size_t p = first; p < last; ++p)
+                                 {
+                                     for (std::size_t k = 0; k < n; ++k)
+                                     {
+                                         const int *source = b.rowData(k) + p * PANEL_WIDTH;
+                                         std::copy(source, source + PANEL_WIDTH, packed.begin() + static_cast<std::ptrdiff_t>((p * n + k) * PANEL_WIDTH));
+                                     }
+                                 }
+                             });
+
+            bool avx2 = CpuFeatures::hasAvx2();
+            std::size_t rowBlocks = (n + ROW_BLOCK - 1) / ROW_BLOCK;
+            pool.parallelFor(0, rowBlocks, 1, [&](std::size_t first, std::size_t last)
+                             {
+                                 for (std::size_t block = first; block < last; ++block)
+                                 {
+                                     std::size_t rowBegin = block * ROW_BLOCK;
+                                     std::size_t rowEnd = std::min(n, rowBegin + ROW_BLOCK);
+                                     for (std::size_t k0 = 0; k0 < n; k0 += DEPTH_BLOCK)
+                                     {
+                                         std::size_t depth = std::min(DEPTH_BLOCK, n - k0);
+                                         for (std::size_t p = 0; p < panels; ++p)
+                                         {
+                                             const int *panel = packed.data() + (p * n + k0) * PANEL_WIDTH;
+                                             std::size_t i = rowBegin;
+                                             for (; i + 4 <= rowEnd; i += 4)
+                                             {
+                                                 const int *rowsA[4] = {a.rowData(i) + k0, a.rowData(i + 1) + k0, a.rowData(i + 2) + k0, a.rowData(i + 3) + k0};
+                                                 int *rowsC[4] = {result.rowData(i) + p * PANEL_WIDTH, result.rowData(i + 1) + p * PANEL_WIDTH,
+                                                                  result.rowData(i + 2) + p * PANEL_WIDTH, result.rowData(i + 3) + p * PANEL_WIDTH};
+                                                 tile<Policy, 4>(avx2, rowsA, panel, depth, rowsC);
+                                             }
+                                             for (; i < rowEnd; ++i)
+                                             {
+                                                 const int *rowA = a.rowData(i) + k0;
+                                                 int *rowC = result.rowData(i) + p * PANEL_WIDTH;
+                                                 tile<Policy, 1>(avx2, &rowA, panel, depth, &rowC);
+                                             }
+                                         }
+                                     }
+                                     for (std::size_t i = rowBegin; i < rowEnd; ++i)
+                                     {
+                                         std::fill(result.rowData(i) + n, result.rowData(i) + result.stride(), 0);
+                                     }
+                                 }
+                             });
+        }
+
+        // Semiring matrix of g: edge weights (1 for OrAnd), missing edges as the semiring zero and the
+        // semiring identity on the diagonal (a negative self-loop is kept for MinPlus)
+        DenseMatrix encode(const Graph &g, Semiring semiring)
+        {
+            std::size_t n = static_cast<std::size_t>(g.getVertices());
+            const CsrAdjacency &adjacency = g.getCsr();
+            int missing = semiring == Semiring::MinPlus ? MinPlus::zero() : (semiring == Semiring::MaxMin ? MaxMin::zero() : 0);
+            DenseMatrix m(n, missing);
+            for (int u = 0; u < g.getVertices(); ++u)
+            {
+                int *row = m.rowData(static_cast<std::size_t>(u));
+                for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+                {
+                    row[adjacency.target(e)] = semiring == Semiring::OrAnd ? 1 : adjacency.weight(e);
+                }
+                int &diagonal = row[u];
+                switch (semiring)
+                {
+                case Semiring::MinPlus:
+                    diagonal = std::min(diagonal, 0);
+                    break;
+                case Semiring::OrAnd:
+                    diagonal = 1;
+                    break;
+                case Semiring::MaxMin:
+                    diagonal = MatrixProduct::INFINITE_DISTANCE;
+                    break;
+                case Semiring::PlusTimes:
+                    break;
+                }
+            }
+            return m;
+        }
+    }
+
+    const int MatrixProduct::INFINITE_DISTANCE;
+    const int MatrixProduct::NO_PATH_WIDTH;
+
+    void MatrixProduct::multiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix &result, Semiring semiring)
+    {
+        switch (semiring)
+        {
+        case Semiring::PlusTimes:
+            multiplyWith<PlusTimes>(a, b, result);
+            break;
+        case Semiring::MinPlus:
+            multiplyWith<MinPlus>(a, b, result);
+            break;
+        case Semiring::OrAnd:
+            multiplyWith<OrAnd>(a, b, result);
+            break;
+        case Semiring::MaxMin:
+            multiplyWith<MaxMin>(a, b, result);
+            break;
+        }
+    }
+
+    DenseMatrix MatrixProduct::closure(const DenseMatrix &m, Semiring semiring)
+    {
+        DenseMatrix current = m;
+        DenseMatrix next;
+        // After s squarings current covers every walk of up to 2^s edges
+        for (std::size_t covered = 1; covered + 1 < m.size(); covered *= 2)
+        {
+            multiply(current, current, next, semiring);
+            if (next == current)
+            {
+                break;
+            }
+            std::swap(current, next);
+        }
+        return current;
+    }
+
+    DenseMatrix MatrixProduct::shortestDistances(const Graph &g)
+    {
+        return closure(encode(g, Semiring::MinPlus), Semiring::MinPlus);
+    }
+
+    DenseMatrix MatrixProduct::reachability(const Graph &g)
+    {
+        return closure(encode(g, Semiring::OrAnd), Semiring::OrAnd);
+    }
+
+    DenseMatrix MatrixProduct::widestPaths(const Graph &g)
+    {
+        return closure(encode(g, Semiring::MaxMin), Semiring::MaxMin);
+    }
+
+}
@@ -0,0 +1,55 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef MATRIX_PRODUCT_HPP
+#define MATRIX_PRODUCT_HPP
+
+#include "DenseMatrix.hpp"
+#include "GraphFwd.hpp"
+#include <climits>
+
+namespace ariel
+{
+
+    // The (add, multiply) pair a matrix product is taken over.
+    //   PlusTimes: ordinary product, counts weighted walks. Wraps modulo 2^32.
+    //   MinPlus:   tropical product, shortest walks. INFINITE_DISTANCE means no walk; sums saturate.
+    //   OrAnd:     boolean product on 0/1 (any non-zero counts as 1), reachability.
+    //   MaxMin:    bottleneck product, widest walks. NO_PATH_WIDTH means no walk.
+    enum class Semiring
+    {
+        PlusTimes,
+        MinPlus,
+        OrAnd,
+        MaxMin
+    };
+
+    // Dense matrix products for the Graph operators and the all-pairs routines.
+    class MatrixProduct
+    {
+    public:
+        static const int INFINITE_DISTANCE = INT_MAX;
+        static const int NO_PATH_WIDTH = INT_MIN;
+
+        // result = a (x) b over the given semiring. Rows of the result are computed in cache-sized
+        // blocks, 4x16 tiles at a time (AVX2 when available), spread over the shared thread pool; the
+        // right operand is first packed into 16-column panels. PlusTimes results are bit-for-bit those
+        // of the naive triple loop.
+        static void multiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix &result, Semiring semiring = Semiring::PlusTimes);
+
+        // m, m^2, m^4, ... until a fixpoint or until the power covers walks of V - 1 edges.
+        // m should already contain the semiring's identity on its diagonal.
+        static DenseMatrix closure(const DenseMatrix &m, Semiring semiring);
+
+        // All-pairs shortest distances by min-plus squaring (INFINITE_DISTANCE if unreachable). A negative
+        // diagonal entry marks a vertex on a negative cycle; the distances are then not meaningful.
+        static DenseMatrix shortestDistances(const Graph &g);
+
+        // Reflexive-transitive closure by boolean squaring: 1 iff v is reachable from u
+        static DenseMatrix reachability(const Graph &g);
+
+        // Widest-path (maximum bottleneck) values by max-min squaring; NO_PATH_WIDTH if unreachable
+        static DenseMatrix widestPaths(const Graph &g);
+    };
+
+}
+
+#endif
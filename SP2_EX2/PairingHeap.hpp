@@ -0,0 +1,158 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef PAIRING_HEAP_HPP
+#define PAIRING_HEAP_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ariel
+{
+
+    // Indexed min pairing heap over the items 0..capacity-1 with O(1) push/decreaseKey and amortized
+    // O(log n) popMin. All links live in flat arrays indexed by item, so no per-node allocation is made.
+    template <typename Key>
+    class PairingHeap
+    {
+    public:
+        explicit PairingHeap(std::size_t capacity)
+            : keys(capacity), child(capacity, NONE), next(capacity, NONE), prev(capacity, NONE), inHeap(capacity, false), root(NONE), count(0) {}
+
+        bool empty() const { return root == NONE; }
+
+        // Removes every item in O(size), so one heap can serve many searches without reallocating
+        void clear()
+        {
+            pairs.clear();
+            if (root != NONE)
+            {
+                pairs.push_back(root);
+            }
+            while (!pairs.empty())
+            {
+                std::size_t i = index(pairs.back());
+                pairs.pop_back();
+                inHeap[i] = false;
+                for (int c = child[i]; c != NONE; c = next[index(c)])
+                {
+                    pairs.push_back(c);
+                }
+            }
+            root = NONE;
+            count = 0;
+        }
+        std::size_t size() const { return count; }
+        bool contains(int item) const { return inHeap[index(item)]; }
+        const Key &key(int item) const { return keys[index(item)]; }
+        int top() const { return root; }
+
+        void push(int item, const Key &key)
+        {
+            std::size_t i = index(item);
+            keys[i] = key;
+            child[i] = next[i] = prev[i] = NONE;
+            inHeap[i] = true;
+            ++count;
+            root = root == NONE ? item : meld(root, item);
+        }
+
+        // key must not be greater than the item's current key
+        void decreaseKey(int item, const Key &key)
+        {
+            std::size_t i = index(item);
+            keys[i] = key;
+            if (item == root)
+            {
+                return;
+            }
+            // Cut the subtree rooted at item out of its parent's child list and meld it with the root
+            std::size_t p = index(prev[i]);
+            if (child[p] == item)
+            {
+                child[p] = next[i];
+            }
+            else
+            {
+                next[p] = next[i];
+            }
+            if (next[i] != NONE)
+            {
+                prev[index(next[i])] = prev[i];
+            }
+            next[i] = prev[i] = NONE;
+            root = meld(root, item);
+        }
+
+        int popMin()
+        {
+            int top = root;
+            std::size_t t = index(top);
+            inHeap[t] = false;
+            --count;
+
+            // Two-pass pairing: meld children left to right in pairs, then fold the pairs right to left
+            pairs.clear();
+            int c = child[t];
+            while (c != NONE)
+            {
+                int a = c;
+                int b = next[index(a)];
+                c = b == NONE ? NONE : next[index(b)];
+                next[index(a)] = prev[index(a)] = NONE;
+                if (b != NONE)
+                {
+                    next[index(b)] = prev[index(b)] = NONE;
+                    a = meld(a, b);
+                }
+                pairs.push_back(a);
+            }
+            root = NONE;
+            for (std::size_t k = pairs.size(); k > 0; --k)
+            {
+                root = root == NONE ? pairs[k - 1] : meld(pairs[k - 1], root);
+            }
+            child[t] = NONE;
+            return top;
+        }
+
+    private:
+        static const int NONE = -1;
+
+        static std::size_t index(int item) { return static_cast<std::size_t>(item); }
+
+        // Links two heap roots; the one with the larger key becomes the leftmost child of the other
+        int meld(int a, int b)
+        {
+            if (keys[index(b)] < keys[index(a)])
+            {
+                int t = a;
+                a = b;
+                b = t;
+            }
+            std::size_t ia = index(a);
+            std::size_t ib = index(b);
+            next[ib] = child[ia];
+            if (child[ia] != NONE)
+            {
+                prev[index(child[ia])] = b;
+            }
+            prev[ib] = a;
+            child[ia] = b;
+            return a;
+        }
+
+        std::vector<Key> keys;
+        std::vector<int> child;
+        std::vector<int> next;
+        std::vector<int> prev; // left sibling, or the parent for a leftmost child
+        std::vector<bool> inHeap;
+        std::vector<int> pairs;
+        int root;
+        std::size_t count;
+    };
+
+    template <typename Key>
+    const int PairingHeap<Key>::NONE;
+
+}
+
+#endif
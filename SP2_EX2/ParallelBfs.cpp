@@ -0,0 +1,230 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ParallelBfs.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    const int ParallelBfs::UNVISITED;
+    const std::size_t ParallelBfs::ALPHA;
+    const std::size_t ParallelBfs::BETA;
+
+    namespace
+    {
+        const std::size_t WORD_BITS = 64;
+        const std::size_t TOP_DOWN_GRAIN = 256;    // frontier vertices per chunk
+        const std::size_t BOTTOM_UP_GRAIN = 8;     // bitmap words per chunk
+
+        typedef std::vector<std::atomic<std::uint64_t>> SharedBitmap;
+
+        std::uint64_t bit(std::size_t v) { return std::uint64_t(1) << (v % WORD_BITS); }
+
+        // Appends the vertex of every set bit of the word starting at vertex base, lowest first
+        void appendBits(std::uint64_t word, std::size_t base, std::vector<int> &vertices)
+        {
+            while (word != 0)
+            {
+                vertices.push_back(static_cast<int>(base + static_cast<std::size_t>(__builtin_ctzll(word))));
+                word &= word - 1;
+            }
+        }
+
+        // Fills depth and returns the number of reached vertices
+        std::size_t search(const CsrStructure &out, const CsrStructure &in, const BitAdjacency *bits, int source, std::vector<int> &depth)
+        {
+            if (source < 0 || source >= out.getVertices())
+            {
+                throw std::invalid_argument("Vertex out of range.");
+            }
+            std::size_t n = static_cast<std::size_t>(out.getVertices());
+            std::size_t words = (n + WORD_BITS - 1) / WORD_BITS;
+            ThreadPool &pool = ThreadPool::shared();
+
+            depth.assign(n, ParallelBfs::UNVISITED);
+            SharedBitmap visited(words);
+            for (std::atomic<std::uint64_t> &word : visited)
+            {
+                word.store(0, std::memory_order_relaxed);
+            }
+
+            std::size_t start = static_cast<std::size_t>(source);
+            depth[start] = 0;
+            visited[start / WORD_BITS].store(bit(start), std::memory_order_relaxed);
+
+            std::vector<int> queue(1, source);          // top-down frontier
+            std::vector<std::uint64_t> frontierBits;     // bottom-up frontier
+            std::vector<std::uint64_t> nextBits;
+            std::mutex mergeMutex;
+
+            std::size_t reached = 1;
+            std::size_t frontierSize = 1;
+            std::size_t frontierEdges = out.degree(source);
+            std::size_t unexploredEdges = out.getEdgeCount() - frontierEdges;
+            bool bottomUp = false;
+
+            for (int level = 1; frontierSize > 0; ++level)
+            {
+                if (!bottomUp && frontierEdges > unexploredEdges / ParallelBfs::ALPHA)
+                {
+                    frontierBits.assign(words, 0);
+                    for (int v : queue)
+                    {
+                        frontierBits[static_cast<std::size_t>(v) / WORD_BITS] |= bit(static_cast<std::size_t>(v));
+                    }
+                    bottomUp = true;
+                }
+                else if (bottomUp && frontierSize < n / ParallelBfs::BETA)
+                {
+                    queue.clear();
+                    for (std::size_t v = 0; v < n; ++v)
+                    {
+                        if (frontierBits[v / WORD_BITS] & bit(v))
+                        {
+                            queue.push_back(static_cast<int>(v));
+                        }
+                    }
+                    bottomUp = false;
+                }
+
+                std::atomic<std::size_t> found(0);
+                std::atomic<std::size_t> foundEdges(0);
+                if (bottomUp && bits)
+                {
+                    // Every thread owns a range of words of the next frontier and ORs that slice of the
+                    // bit row of every frontier vertex into it: 64 candidate edges per AND-NOT
+                    std::vector<int> frontier;
+                    for (std::size_t w = 0; w < words; ++w)
+                    {
+                        appendBits(frontierBits[w], w * WORD_BITS, frontier);
+                    }
+                    nextBits.assign(words, 0);
+                    pool.parallelFor(0, words, BOTTOM_UP_GRAIN, [&](std::size_t first, std::size_t last)
+                                     {
+                                         std::vector<std::uint64_t> reach(last - first, 0);
+                                         for (int u : frontier)
+                                         {
+                                             const std::uint64_t *row = bits->row(u) + first;
+                                             for (std::size_t w = 0; w < reach.size(); ++w)
+                                             {
+                                                 reach[w] |= row[w];
+                                             }
+                                         }
+                                         std::vector<int> discoveredVertices;
+                                         for (std::size_t w = first; w < last; ++w)
+                                         {
+                                             std::uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                                             std::uint64_t discovered = reach[w - first] & ~seen;
+                                             nextBits[w] = discovered;
+                                             visited[w].store(seen | discovered, std::memory_order_relaxed);
+                                             appendBits(discovered, w * WORD_BITS, discoveredVertices);
+                                         }
+                                         std::size_t localEdges = 0;
+                                         for (int v : discoveredVertices)
+                                         {
+                                             depth[static_cast<std::size_t>(v)] = level;
+                                             localEdges += out.degree(v);
+                                         }
+                                         found += discoveredVertices.size();
+                                         foundEdges += localEdges;
+                                     });
+                    frontierBits.swap(nextBits);
+                }
+                else if (bottomUp)
+                {
+                    nextBits.assign(words, 0);
+                    pool.parallelFor(0, words, BOTTOM_UP_GRAIN, [&](std::size_t first, std::size_t last)
+                                     {
+                                         std::size_t localFound = 0, localEdges = 0;
+                                         for (std::size_t w = first; w < last; ++w)
+                                         {
+                                             std::uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                                             std::uint64_t discovered = 0;
+                                             std::size_t end = std::min(n, (w + 1) * WORD_BITS);
+                                             for (std::size_t v = w * WORD_BITS; v < end; ++v)
+                                             {
+                                                 if (seen & bit(v))
+                                                 {
+                                                     continue;
+                                                 }
+                                                 int vertex = static_cast<int>(v);
+                                                 for (std::size_t e = in.rowBegin(vertex); e < in.rowEnd(vertex); ++e)
+                                                 {
+                                                     std::size_t u = static_cast<std::size_t>(in.target(e));
+                                                     if (frontierBits[u / WORD_BITS] & bit(u))
+                                                     {
+                                                         discovered |= bit(v);
+                                                         depth[v] = level;
+                                                         ++localFound;
+                                                         localEdges += out.degree(vertex);
+                                                         break;
+                                                     }
+                                                 }
+                                             }
+                                             nextBits[w] = discovered;
+                                             visited[w].store(seen | discovered, std::memory_order_relaxed);
+                                         }
+                                         found += localFound;
+                                         foundEdges += localEdges;
+                                     });
+                    frontierBits.swap(nextBits);
+                }
+                else
+                {
+                    std::vector<int> next;
+                    pool.parallelFor(0, queue.size(), TOP_DOWN_GRAIN, [&](std::size_t first, std::size_t last)
+                                     {
+                                         std::vector<int> local;
+                                         std::size_t localEdges = 0;
+                                         for (std::size_t i = first; i < last; ++i)
+                                         {
+                                             int u = queue[i];
+                                             for (std::size_t e = out.rowBegin(u); e < out.rowEnd(u); ++e)
+                                             {
+                                                 std::size_t v = static_cast<std::size_t>(out.target(e));
+                                                 std::atomic<std::uint64_t> &word = visited[v / WORD_BITS];
+                                                 if ((word.load(std::memory_order_relaxed) & bit(v)) != 0 ||
+                                                     (word.fetch_or(bit(v), std::memory_order_relaxed) & bit(v)) != 0)
+                                                 {
+                                                     continue;
+                                                 }
+                                                 depth[v] = level;
+                                                 local.push_back(static_cast<int>(v));
+                                                 localEdges += out.degree(static_cast<int>(v));
+                                             }
+                                         }
+                                         std::lock_guard<std::mutex> lock(mergeMutex);
+                                         next.insert(next.end(), local.begin(), local.end());
+                                         foundEdges += localEdges;
+                                     });
+                    found = next.size();
+                    queue.swap(next);
+                }
+
+                frontierSize = found;
+                frontierEdges = foundEdges;
+                unexploredEdges -= frontierEdges;
+                reached += frontierSize;
+            }
+            return reached;
+        }
+    }
+
+    std::vector<int> ParallelBfs::levels(const CsrStructure &out, const CsrStructure &in, const BitAdjacency *bits, int source)
+    {
+        std::vector<int> depth;
+        search(out, in, bits, source, depth);
+        return depth;
+    }
+
+    std::size_t ParallelBfs::reachableCount(const CsrStructure &out, const CsrStructure &in, const BitAdjacency *bits, int source)
+    {
+        std::vector<int> depth;
+        return search(out, in, bits, source, depth);
+    }
+
+}
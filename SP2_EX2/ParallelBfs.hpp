@@ -0,0 +1,57 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef PARALLEL_BFS_HPP
+#define PARALLEL_BFS_HPP
+
+#include "BitAdjacency.hpp"
+#include "CsrAdjacency.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace ariel
+{
+
+    // Level-synchronous, direction-optimizing BFS (Beamer et al.) on the shared thread pool.
+    // Small frontiers expand top-down: every thread claims new vertices in a shared atomic bitmap and
+    // collects them in its own list, and the lists are concatenated into the next frontier. Once the
+    // frontier's out-edges outnumber the unexplored edges / ALPHA, levels run bottom-up instead: each
+    // unvisited vertex scans its in-edges for a frontier parent and stops at the first hit. Threads own
+    // whole 64-vertex words there, so no atomics are needed. On graphs dense enough for
+    // BitAdjacency::isWorthwhile, bottom-up levels instead OR the bit rows of the frontier into the
+    // owned words, 64 edges per operation. Back to top-down when the frontier drops below V / BETA.
+    class ParallelBfs
+    {
+    public:
+        static const int UNVISITED = -1;
+        static const std::size_t ALPHA = 14;
+        static const std::size_t BETA = 24;
+
+        // Number of edges from source to each vertex, UNVISITED if it is unreachable. Works on any
+        // BasicGraph; the bit rows are only built when BitAdjacency::isWorthwhile.
+        template <typename G>
+        static std::vector<int> levels(const G &g, int source)
+        {
+            return levels(g.getCsr(), g.getReverseCsr(), bitsOf(g), source);
+        }
+
+        // Number of vertices reachable from source, source included
+        template <typename G>
+        static std::size_t reachableCount(const G &g, int source)
+        {
+            return reachableCount(g.getCsr(), g.getReverseCsr(), bitsOf(g), source);
+        }
+
+        // The same over out- and in-edge structures; bits, if given, are the rows of out
+        static std::vector<int> levels(const CsrStructure &out, const CsrStructure &in, const BitAdjacency *bits, int source);
+        static std::size_t reachableCount(const CsrStructure &out, const CsrStructure &in, const BitAdjacency *bits, int source);
+
+    private:
+        template <typename G>
+        static const BitAdjacency *bitsOf(const G &g)
+        {
+            return BitAdjacency::isWorthwhile(g.getCsr()) ? &g.getBitAdjacency() : nullptr;
+        }
+    };
+
+}
+
+#endif
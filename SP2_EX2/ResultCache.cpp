@@ -0,0 +1,92 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ResultCache.hpp"
+#include <stdexcept>
+
+namespace ariel
+{
+
+    bool ResultCache::Key::operator<(const Key &other) const
+    {
+        if (version != other.version)
+        {
+            return version < other.version;
+        }
+        if (query != other.query)
+        {
+            return query < other.query;
+        }
+        return argument < other.argument;
+    }
+
+    ResultCache::ResultCache(std::size_t capacity) : capacity(capacity), hits(0), misses(0)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Cache capacity must be positive.");
+        }
+    }
+
+    ResultCache &ResultCache::shared()
+    {
+        static ResultCache cache;
+        return cache;
+    }
+
+    std::string ResultCache::lookup(Query query, const Graph &g, int argument, const std::function<std::string()> &compute)
+    {
+        Key key = {query, g.getVersion(), argument};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::map<Key, EntryList::iterator>::iterator found = byKey.find(key);
+            if (found != byKey.end())
+            {
+                ++hits;
+                entries.splice(entries.begin(), entries, found->second);
+                return entries.front().second;
+            }
+            ++misses;
+        }
+
+        std::string result = compute();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // Another thread may have stored the same result meanwhile
+        if (byKey.find(key) == byKey.end())
+        {
+            entries.push_front(std::make_pair(key, result));
+            byKey[key] = entries.begin();
+            if (entries.size() > capacity)
+            {
+                byKey.erase(entries.back().first);
+                entries.pop_back();
+            }
+        }
+        return result;
+    }
+
+    void ResultCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        byKey.clear();
+    }
+
+    std::size_t ResultCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    std::uint64_t ResultCache::getHits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hits;
+    }
+
+    std::uint64_t ResultCache::getMisses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return misses;
+    }
+
+}
@@ -0,0 +1,69 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace ariel
+{
+
+    // Results of whole-graph queries keyed on (query, graph version, argument). Versions are globally
+    // unique, so an entry is only ever served for the graph it was computed on or an unmodified copy of
+    // it; entries of graphs that changed since simply age out. At most capacity results are kept, least
+    // recently used evicted first. Safe to use from several threads.
+    class ResultCache
+    {
+    public:
+        enum class Query
+        {
+            IsConnected,
+            IsContainsCycle,
+            IsBipartite,
+            NegativeCycle
+        };
+
+        explicit ResultCache(std::size_t capacity = 256);
+        ResultCache(const ResultCache &) = delete;
+        ResultCache &operator=(const ResultCache &) = delete;
+
+        // Process-wide cache behind the Algorithms queries
+        static ResultCache &shared();
+
+        // The stored result, or else compute()'s, which is stored. compute runs without the lock held,
+        // and nothing is stored if it throws.
+        std::string lookup(Query query, const Graph &g, int argument, const std::function<std::string()> &compute);
+
+        void clear();
+        std::size_t size() const;
+        std::size_t getCapacity() const { return capacity; }
+        std::uint64_t getHits() const;
+        std::uint64_t getMisses() const;
+
+    private:
+        struct Key
+        {
+            Query query;
+            std::uint64_t version;
+            int argument;
+
+            bool operator<(const Key &other) const;
+        };
+        typedef std::list<std::pair<Key, std::string>> EntryList;
+
+        std::size_t capacity;
+        mutable std::mutex mutex;
+        EntryList entries; // most recently used first
+        std::map<Key, EntryList::iterator> byKey;
+        std::uint64_t hits;
+        std::uint64_t misses;
+    };
+
+}
+
+#endif
@@ -0,0 +1,374 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ShortestPaths.hpp"
+#include "Avx2Ops.hpp"
+#include "CpuFeatures.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace ariel
+{
+
+    namespace
+    {
+        // dist[v] = min(dist[v], du + row[v]) over the non-zero row entries, recording u as the parent of
+        // every improved v. Rows and arrays are padded to the matrix stride, whose padding holds no edges.
+        // Returns true if anything improved; sets saturated if an improvement was clamped to INT_MIN.
+        typedef bool (*DenseRelax)(int *dist, int *parent, const int *row, std::size_t stride, int du, int u, bool &saturated);
+
+        bool relaxDenseScalar(int *dist, int *parent, const int *row, std::size_t stride, int du, int u, bool &saturated)
+        {
+            bool changed = false;
+            for (std::size_t v = 0; v < stride; ++v)
+            {
+                if (row[v] == 0)
+                {
+                    continue;
+                }
+                long long sum = static_cast<long long>(du) + row[v];
+                int candidate = sum > INT_MAX ? INT_MAX : (sum < INT_MIN ? INT_MIN : static_cast<int>(sum));
+                if (candidate < dist[v])
+                {
+                    dist[v] = candidate;
+                    parent[v] = u;
+                    changed = true;
+                    saturated = saturated || candidate == INT_MIN;
+                }
+            }
+            return changed;
+        }
+
+#if ARIEL_X86_DISPATCH
+        ARIEL_TARGET_AVX2 bool relaxDenseAvx2(int *dist, int *parent, const int *row, std::size_t stride, int du, int u, bool &saturated)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i floor = _mm256_set1_epi32(INT_MIN);
+            const __m256i via = _mm256_set1_epi32(du);
+            const __m256i from = _mm256_set1_epi32(u);
+            __m256i anyBetter = zero;
+            __m256i anyFloor = zero;
+            for (std::size_t v = 0; v < stride; v += 8)
+            {
+                __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + v));
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dist + v));
+                __m256i candidate = avx2::saturatingAdd(via, weights);
+                // Improved lanes: candidate < current and the entry is an edge
+                __m256i better = _mm256_andnot_si256(_mm256_cmpeq_epi32(weights, zero), _mm256_cmpgt_epi32(current, candidate));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dist + v), _mm256_blendv_epi8(current, _mm256_min_epi32(current, candidate), better));
+                __m256i parents = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(parent + v));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(parent + v), _mm256_blendv_epi8(parents, from, better));
+                anyBetter = _mm256_or_si256(anyBetter, better);
+                anyFloor = _mm256_or_si256(anyFloor, _mm256_and_si256(better, _mm256_cmpeq_epi32(candidate, floor)));
+            }
+            saturated = saturated || !_mm256_testz_si256(anyFloor, anyFloor);
+            return !_mm256_testz_si256(anyBetter, anyBetter);
+        }
+#endif
+    }
+
+    ShortestPathTree ShortestPaths::dijkstra(const CsrAdjacency &adjacency, int source, const std::vector<Distance> &potential)
+    {
+        if (potential.size() != static_cast<std::size_t>(adjacency.getVertices()))
+        {
+            throw std::invalid_argument("Potential must have one entry per vertex.");
+        }
+        ShortestPathTree tree = runDijkstra(adjacency, source, [&potential](int u, int v, int w)
+                                            { return w + potential[static_cast<std::size_t>(u)] - potential[static_cast<std::size_t>(v)]; });
+        Distance shift = potential[static_cast<std::size_t>(source)];
+        for (std::size_t v = 0; v < tree.distance.size(); ++v)
+        {
+            if (tree.distance[v] != ShortestPathTree::UNREACHABLE)
+            {
+                tree.distance[v] += potential[v] - shift;
+            }
+        }
+        return tree;
+    }
+
+    Distance ShortestPaths::defaultDelta(const CsrAdjacency &adjacency)
+    {
+        const std::vector<int> &weights = adjacency.getWeights();
+        if (weights.empty())
+        {
+            return 1;
+        }
+        Distance heaviest = *std::max_element(weights.begin(), weights.end());
+        Distance degree = static_cast<Distance>(weights.size() / static_cast<std::size_t>(adjacency.getVertices()));
+        return std::max<Distance>(1, heaviest / std::max<Distance>(1, degree));
+    }
+
+    ShortestPathTree ShortestPaths::deltaStepping(const CsrAdjacency &adjacency, int source, Distance delta)
+    {
+        ShortestPathTree tree = emptyTree<Distance>(adjacency.getVertices(), source);
+        if (hasNegativeWeights(adjacency))
+        {
+            throw std::invalid_argument("Delta-stepping requires non-negative weights.");
+        }
+        if (delta < 0)
+        {
+            throw std::invalid_argument("Delta must be positive.");
+        }
+        if (delta == 0)
+        {
+            delta = defaultDelta(adjacency);
+        }
+
+        const std::size_t GRAIN = 64; // vertices per chunk
+        std::size_t n = static_cast<std::size_t>(adjacency.getVertices());
+        ThreadPool &pool = ThreadPool::shared();
+        std::vector<std::atomic<Distance>> distance(n);
+        for (std::atomic<Distance> &d : distance)
+        {
+            d.store(ShortestPathTree::UNREACHABLE, std::memory_order_relaxed);
+        }
+        distance[static_cast<std::size_t>(source)].store(0, std::memory_order_relaxed);
+
+        typedef std::vector<std::pair<Distance, int>> Insertions; // (bucket, vertex)
+        std::map<Distance, std::vector<int>> buckets;
+        std::mutex bucketMutex;
+        buckets[0].push_back(source);
+
+        // Relaxes the light or the heavy edges of the given vertices; improved vertices go to their
+        // new bucket, or to current if that is the bucket being emptied
+        auto relaxAll = [&](const std::vector<int> &vertices, bool light, Distance index, std::vector<int> &current)
+        {
+            pool.parallelFor(0, vertices.size(), GRAIN, [&](std::size_t first, std::size_t last)
+                             {
+                                 Insertions local;
+                                 for (std::size_t i = first; i < last; ++i)
+                                 {
+                                     int u = vertices[i];
+                                     Distance du = distance[static_cast<std::size_t>(u)].load(std::memory_order_relaxed);
+                                     for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+                                     {
+                                         if ((adjacency.weight(e) <= delta) != light)
+                                         {
+                                             continue;
+                                         }
+                                         Distance candidate = du + adjacency.weight(e);
+                                         std::atomic<Distance> &dv = distance[static_cast<std::size_t>(adjacency.target(e))];
+                                         Distance old = dv.load(std::memory_order_relaxed);
+                                         while (candidate < old)
+                                         {
+                                             if (dv.compare_exchange_weak(old, candidate, std::memory_order_relaxed))
+                                             {
+                                                 local.push_back(std::make_pair(candidate / delta, adjacency.target(e)));
+                                                 break;
+                                             }
+                                         }
+                                     }
+                                 }
+                                 std::lock_guard<std::mutex> lock(bucketMutex);
+                                 for (const std::pair<Distance, int> &entry : local)
+                                 {
+                                     (entry.first == index ? current : buckets[entry.first]).push_back(entry.second);
+                                 }
+                             });
+        };
+
+        // stamp[v] == phase: v is already in this round's frontier; settledIn[v] == index: v was settled in this bucket
+        std::vector<Distance> stamp(n, -1);
+        std::vector<Distance> settledIn(n, -1);
+        Distance phase = 0;
+        std::vector<int> frontier, next, settled;
+        while (!buckets.empty())
+        {
+            Distance index = buckets.begin()->first;
+            next.swap(buckets.begin()->second);
+            buckets.erase(buckets.begin());
+            settled.clear();
+
+            while (!next.empty())
+            {
+                // Drop duplicates and entries that have since moved to a lower bucket
+                frontier.clear();
+                ++phase;
+                for (int v : next)
+                {
+                    std::size_t sv = static_cast<std::size_t>(v);
+                    if (stamp[sv] != phase && distance[sv].load(std::memory_order_relaxed) / delta == index)
+                    {
+                        stamp[sv] = phase;
+                        frontier.push_back(v);
+                        if (settledIn[sv] != index)
+                        {
+                            settledIn[sv] = index;
+                            settled.push_back(v);
+                        }
+                    }
+                }
+                next.clear();
+                relaxAll(frontier, true, index, next);
+            }
+            // Heavy edges always leave the bucket, so one pass suffices
+            relaxAll(settled, false, index, next);
+        }
+
+        // Parents: the lowest-numbered u with d(u) + w(u, v) = d(v). Weights are positive, so these
+        // edges form a DAG and any such choice is a shortest path tree.
+        std::vector<std::atomic<int>> parent(n);
+        for (std::atomic<int> &p : parent)
+        {
+            p.store(adjacency.getVertices(), std::memory_order_relaxed);
+        }
+        pool.parallelFor(0, n, GRAIN * 16, [&](std::size_t first, std::size_t last)
+                         {
+                             for (std::size_t su = first; su < last; ++su)
+                             {
+                                 int u = static_cast<int>(su);
+                                 Distance du = distance[su].load(std::memory_order_relaxed);
+                                 if (du == ShortestPathTree::UNREACHABLE)
+                                 {
+                                     continue;
+                                 }
+                                 for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+                                 {
+                                     std::size_t v = static_cast<std::size_t>(adjacency.target(e));
+                                     if (v == static_cast<std::size_t>(source) || du + adjacency.weight(e) != distance[v].load(std::memory_order_relaxed))
+                                     {
+                                         continue;
+                                     }
+                                     int old = parent[v].load(std::memory_order_relaxed);
+                                     while (u < old && !parent[v].compare_exchange_weak(old, u, std::memory_order_relaxed))
+                                     {
+                                     }
+                                 }
+                             }
+                         });
+
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            tree.distance[v] = distance[v].load(std::memory_order_relaxed);
+            int p = parent[v].load(std::memory_order_relaxed);
+            tree.parent[v] = p == adjacency.getVertices() ? -1 : p;
+        }
+        return tree;
+    }
+
+    bool ShortestPaths::potentials(const CsrAdjacency &adjacency, std::vector<Distance> &potential)
+    {
+        std::vector<int> cycle;
+        return virtualSourceSpfa(adjacency, potential, cycle);
+    }
+
+    std::vector<int> ShortestPaths::findNegativeCycleDense(const DenseMatrix &adjacency)
+    {
+        std::size_t n = adjacency.size();
+        std::size_t stride = adjacency.stride();
+        DenseRelax relax = relaxDenseScalar;
+#if ARIEL_X86_DISPATCH
+        if (CpuFeatures::hasAvx2())
+        {
+            relax = relaxDenseAvx2;
+        }
+#endif
+
+        // Every vertex starts at 0 through its edge from the virtual source, which is its parent (-1)
+        std::vector<int> dist(stride, 0);
+        std::vector<int> parent(stride, -1);
+        bool saturated = false;
+        bool changed = true;
+        // V + 1 vertices with the virtual source: a change in round V + 1 proves a negative cycle
+        for (std::size_t round = 0; round <= n && changed && !saturated; ++round)
+        {
+            changed = false;
+            for (std::size_t u = 0; u < n; ++u)
+            {
+                changed = relax(dist.data(), parent.data(), adjacency.rowData(u), stride, dist[u], static_cast<int>(u), saturated) || changed;
+            }
+        }
+        if (saturated)
+        {
+            return findNegativeCycle(CsrAdjacency::fromMatrix(adjacency));
+        }
+        if (!changed)
+        {
+            return std::vector<int>();
+        }
+
+        // Relaxation has not settled after V + 1 rounds, so the parent pointers contain a cycle, and
+        // every cycle among them is negative. Find one by following pointers, marking each walk.
+        std::vector<int> walk(n, -1);
+        for (std::size_t first = 0; first < n; ++first)
+        {
+            int v = static_cast<int>(first);
+            while (v != -1 && walk[static_cast<std::size_t>(v)] == -1)
+            {
+                walk[static_cast<std::size_t>(v)] = static_cast<int>(first);
+                v = parent[static_cast<std::size_t>(v)];
+            }
+            if (v == -1 || walk[static_cast<std::size_t>(v)] != static_cast<int>(first))
+            {
+                continue; // reached the virtual source or an earlier walk
+            }
+            std::vector<int> cycle(1, v);
+            for (int u = parent[static_cast<std::size_t>(v)]; u != v; u = parent[static_cast<std::size_t>(u)])
+            {
+                cycle.push_back(u);
+            }
+            std::reverse(cycle.begin(), cycle.end());
+            return cycle;
+        }
+        return findNegativeCycle(CsrAdjacency::fromMatrix(adjacency));
+    }
+
+    bool ShortestPaths::preferDense(const Graph &g)
+    {
+        // At least one edge per 8 cells: one 8-lane step per edge or better
+        std::size_t n = static_cast<std::size_t>(g.getVertices());
+        return g.isDense() && 8 * g.getEdgeCount() >= n * n;
+    }
+
+    ShortestPathCache::ShortestPathCache(const Graph &g, std::size_t capacity)
+        : graph(g), capacity(capacity), version(g.getVersion())
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Cache capacity must be positive.");
+        }
+    }
+
+    const ShortestPathTree &ShortestPathCache::tree(int source)
+    {
+        if (version != graph.getVersion())
+        {
+            trees.clear();
+            bySource.clear();
+            version = graph.getVersion();
+        }
+
+        std::unordered_map<int, TreeList::iterator>::iterator found = bySource.find(source);
+        if (found != bySource.end())
+        {
+            trees.splice(trees.begin(), trees, found->second);
+            return trees.front();
+        }
+
+        trees.push_front(ShortestPaths::compute(graph, source));
+        bySource[source] = trees.begin();
+        if (trees.size() > capacity)
+        {
+            bySource.erase(trees.back().source);
+            trees.pop_back();
+        }
+        return trees.front();
+    }
+
+    RowView<const Distance> ShortestPathCache::distances(int source)
+    {
+        const ShortestPathTree &t = tree(source);
+        return RowView<const Distance>(t.distance.data(), t.distance.size());
+    }
+
+    template ShortestPathTree ShortestPaths::compute<int>(const Graph &g, int source);
+    template bool ShortestPaths::hasNegativeWeights<int>(const CsrAdjacency &adjacency);
+    template ShortestPathTree ShortestPaths::dijkstra<int>(const CsrAdjacency &adjacency, int source);
+    template ShortestPathTree ShortestPaths::bellmanFord<int>(const CsrAdjacency &adjacency, int source);
+    template std::vector<int> ShortestPaths::findNegativeCycle<int>(const CsrAdjacency &adjacency);
+
+}
@@ -0,0 +1,427 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef SHORTEST_PATHS_HPP
+#define SHORTEST_PATHS_HPP
+
+#include "Graph.hpp"
+#include "PairingHeap.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace ariel
+{
+
+    // Path lengths are accumulated in 64 bits so that long paths of int weights cannot overflow
+    typedef std::int64_t Distance;
+
+    // Single-source shortest path tree over path lengths of type D: distance[v] and parent[v] for
+    // every vertex v.
+    template <typename D>
+    struct BasicShortestPathTree
+    {
+        static const D UNREACHABLE;
+
+        int source;
+        std::vector<D> distance; // UNREACHABLE if there is no path
+        std::vector<int> parent; // -1 for the source and for unreachable vertices
+        bool negativeCycle;      // a negative cycle is reachable from the source; distances are meaningless
+
+        // The queries below throw std::invalid_argument if v is not a vertex of the graph
+        bool reaches(int v) const { return distance[checkedVertex(v)] != UNREACHABLE; }
+
+        // UNREACHABLE if v is unreachable or the distances are undefined
+        D distanceTo(int v) const
+        {
+            std::size_t sv = checkedVertex(v);
+            return negativeCycle ? UNREACHABLE : distance[sv];
+        }
+
+        // Vertices from source to v, or an empty vector if v is unreachable. The second form reuses
+        // the caller's buffer so repeated queries do not allocate.
+        std::vector<int> pathTo(int v) const
+        {
+            std::vector<int> path;
+            pathTo(v, path);
+            return path;
+        }
+
+        void pathTo(int v, std::vector<int> &path) const
+        {
+            path.clear();
+            if (negativeCycle || !reaches(v))
+            {
+                return;
+            }
+            for (int current = v; current != -1; current = parent[static_cast<std::size_t>(current)])
+            {
+                path.push_back(current);
+            }
+            std::reverse(path.begin(), path.end());
+        }
+
+    private:
+        std::size_t checkedVertex(int v) const
+        {
+            if (v < 0 || static_cast<std::size_t>(v) >= distance.size())
+            {
+                throw std::invalid_argument("Vertex out of range.");
+            }
+            return static_cast<std::size_t>(v);
+        }
+    };
+
+    template <typename D>
+    const D BasicShortestPathTree<D>::UNREACHABLE = std::numeric_limits<D>::max();
+
+    typedef BasicShortestPathTree<Distance> ShortestPathTree;
+
+    // The tree of a graph with weights W, over lengths summed in WeightTraits<W>::Sum
+    template <typename W>
+    using ShortestPathTreeOf = BasicShortestPathTree<typename WeightTraits<W>::Sum>;
+
+    // The routines templated over the weight type serve every BasicGraph<W>; the int ones
+    // (ariel::Graph) are compiled once in ShortestPaths.cpp. The rest are int-only kernels.
+    class ShortestPaths
+    {
+    public:
+        // Dijkstra when every weight is non-negative, Bellman-Ford otherwise
+        template <typename W>
+        static ShortestPathTreeOf<W> compute(const BasicGraph<W> &g, int source);
+
+        template <typename W>
+        static bool hasNegativeWeights(const BasicCsrAdjacency<W> &adjacency);
+
+        // Dijkstra over a pairing heap; all weights must be non-negative
+        template <typename W>
+        static ShortestPathTreeOf<W> dijkstra(const BasicCsrAdjacency<W> &adjacency, int source);
+
+        // Dijkstra on the reduced weights w(u, v) + potential[u] - potential[v], which must be
+        // non-negative; the returned distances are in the original weights
+        static ShortestPathTree dijkstra(const CsrAdjacency &adjacency, int source, const std::vector<Distance> &potential);
+
+        // Parallel delta-stepping on the shared thread pool; all weights must be non-negative. Vertices
+        // are kept in buckets of width delta. The lowest bucket is emptied by relaxing light edges
+        // (weight <= delta) in parallel rounds until nothing falls back into it, then the heavy edges of
+        // everything it settled are relaxed once. Each chunk of work collects its bucket insertions
+        // locally before they are merged. delta = 0 picks defaultDelta(). Distances equal dijkstra's.
+        // Each parent is the lowest-numbered predecessor on a shortest path, so the tree does not
+        // depend on scheduling.
+        static ShortestPathTree deltaStepping(const CsrAdjacency &adjacency, int source, Distance delta = 0);
+
+        // Largest weight over average out-degree, at least 1
+        static Distance defaultDelta(const CsrAdjacency &adjacency);
+
+        // Bellman-Ford with early exit once a round relaxes nothing; handles negative weights
+        template <typename W>
+        static ShortestPathTreeOf<W> bellmanFord(const BasicCsrAdjacency<W> &adjacency, int source);
+
+        // Shortest distances from a virtual source with a zero-weight edge to every vertex. Fills
+        // potential with a feasible potential for Johnson's reweighting and returns false if the graph
+        // has a negative cycle anywhere.
+        static bool potentials(const CsrAdjacency &adjacency, std::vector<Distance> &potential);
+
+        // Vertices of a negative cycle anywhere in the graph, in edge order, or an empty vector.
+        // SPFA from the same virtual source with Tarjan's subtree disassembly: it stops as soon as
+        // the queue empties, or as soon as the parent tree would close a cycle.
+        template <typename W>
+        static std::vector<int> findNegativeCycle(const BasicCsrAdjacency<W> &adjacency);
+
+        // Same answer from the adjacency matrix (0 = no edge): Bellman-Ford rounds from the virtual
+        // source where each vertex relaxes its whole row at once with an AVX2 min/blend kernel, or a
+        // scalar one. Stops after the first round without a change. Falls back to findNegativeCycle if a
+        // distance would drop below INT_MIN.
+        static std::vector<int> findNegativeCycleDense(const DenseMatrix &adjacency);
+
+        // True when the matrix is full enough for findNegativeCycleDense to beat the CSR search
+        static bool preferDense(const Graph &g);
+
+    private:
+        template <typename D>
+        static BasicShortestPathTree<D> emptyTree(int numVertices, int source);
+
+        // Dijkstra where weightOf(u, v, w) gives the non-negative length used for edge u -> v of weight w
+        template <typename W, typename WeightOf>
+        static ShortestPathTreeOf<W> runDijkstra(const BasicCsrAdjacency<W> &adjacency, int source, WeightOf weightOf);
+
+        // Queue-based Bellman-Ford (SPFA) from a virtual source with a zero-weight edge to every vertex,
+        // using Tarjan's subtree disassembly. The current parent tree is kept as a preorder list with
+        // depths. When v improves, its whole subtree is unlinked and its vertices are not scanned until
+        // they improve again. Finding u, the vertex being scanned, inside that subtree means the parent
+        // graph would close a cycle through u -> v, which is negative; it is reported at once instead of
+        // after V rounds. Returns false and fills cycle if there is a negative cycle.
+        template <typename W>
+        static bool virtualSourceSpfa(const BasicCsrAdjacency<W> &adjacency, std::vector<typename WeightTraits<W>::Sum> &distance, std::vector<int> &cycle);
+    };
+
+    // Serves many queries from the same sources: each source's tree is computed once and reused until
+    // the graph's version changes. At most capacity trees are kept, least recently used evicted first.
+    // References and views returned here stay valid until the next call that may compute a tree.
+    class ShortestPathCache
+    {
+    public:
+        explicit ShortestPathCache(const Graph &g, std::size_t capacity = 16);
+
+        const ShortestPathTree &tree(int source);
+        Distance distanceTo(int source, int target) { return tree(source).distanceTo(target); }
+        std::vector<int> pathTo(int source, int target) { return tree(source).pathTo(target); }
+        void pathTo(int source, int target, std::vector<int> &path) { tree(source).pathTo(target, path); }
+
+        // Distances from source to every vertex, indexed by vertex
+        RowView<const Distance> distances(int source);
+
+        std::size_t size() const { return trees.size(); }
+        std::size_t getCapacity() const { return capacity; }
+
+    private:
+        typedef std::list<ShortestPathTree> TreeList;
+
+        const Graph &graph;
+        std::size_t capacity;
+        std::uint64_t version;
+        TreeList trees; // most recently used first
+        std::unordered_map<int, TreeList::iterator> bySource;
+    };
+
+    template <typename W>
+    ShortestPathTreeOf<W> ShortestPaths::compute(const BasicGraph<W> &g, int source)
+    {
+        const BasicCsrAdjacency<W> &adjacency = g.getCsr();
+        if (hasNegativeWeights(adjacency))
+        {
+            return bellmanFord(adjacency, source);
+        }
+        return dijkstra(adjacency, source);
+    }
+
+    template <typename W>
+    bool ShortestPaths::hasNegativeWeights(const BasicCsrAdjacency<W> &adjacency)
+    {
+        const std::vector<W> &weights = adjacency.getWeights();
+        return std::any_of(weights.begin(), weights.end(), [](W w) { return w < W(); });
+    }
+
+    template <typename W>
+    ShortestPathTreeOf<W> ShortestPaths::dijkstra(const BasicCsrAdjacency<W> &adjacency, int source)
+    {
+        typedef typename WeightTraits<W>::Sum Length;
+        return runDijkstra(adjacency, source, [](int, int, W w) { return static_cast<Length>(w); });
+    }
+
+    template <typename W>
+    ShortestPathTreeOf<W> ShortestPaths::bellmanFord(const BasicCsrAdjacency<W> &adjacency, int source)
+    {
+        typedef typename WeightTraits<W>::Sum Length;
+        int numVertices = adjacency.getVertices();
+        ShortestPathTreeOf<W> tree = emptyTree<Length>(numVertices, source);
+
+        // Without a negative cycle everything settles within V - 1 rounds; a change in round V proves one
+        for (int round = 0; round < numVertices; ++round)
+        {
+            bool changed = false;
+            for (int u = 0; u < numVertices; ++u)
+            {
+                Length du = tree.distance[static_cast<std::size_t>(u)];
+                if (du == ShortestPathTreeOf<W>::UNREACHABLE)
+                {
+                    continue;
+                }
+                for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+                {
+                    std::size_t v = static_cast<std::size_t>(adjacency.target(e));
+                    if (du + adjacency.weight(e) < tree.distance[v])
+                    {
+                        tree.distance[v] = du + adjacency.weight(e);
+                        tree.parent[v] = u;
+                        changed = true;
+                    }
+                }
+            }
+            if (!changed)
+            {
+                return tree;
+            }
+        }
+        tree.negativeCycle = true;
+        return tree;
+    }
+
+    template <typename W>
+    std::vector<int> ShortestPaths::findNegativeCycle(const BasicCsrAdjacency<W> &adjacency)
+    {
+        std::vector<typename WeightTraits<W>::Sum> distance;
+        std::vector<int> cycle;
+        virtualSourceSpfa(adjacency, distance, cycle);
+        return cycle;
+    }
+
+    template <typename D>
+    BasicShortestPathTree<D> ShortestPaths::emptyTree(int numVertices, int source)
+    {
+        if (source < 0 || source >= numVertices)
+        {
+            throw std::invalid_argument("Vertex out of range.");
+        }
+        BasicShortestPathTree<D> tree;
+        tree.source = source;
+        tree.distance.assign(static_cast<std::size_t>(numVertices), BasicShortestPathTree<D>::UNREACHABLE);
+        tree.parent.assign(static_cast<std::size_t>(numVertices), -1);
+        tree.negativeCycle = false;
+        tree.distance[static_cast<std::size_t>(source)] = 0;
+        return tree;
+    }
+
+    template <typename W, typename WeightOf>
+    ShortestPathTreeOf<W> ShortestPaths::runDijkstra(const BasicCsrAdjacency<W> &adjacency, int source, WeightOf weightOf)
+    {
+        typedef typename WeightTraits<W>::Sum Length;
+        ShortestPathTreeOf<W> tree = emptyTree<Length>(adjacency.getVertices(), source);
+        PairingHeap<Length> heap(static_cast<std::size_t>(adjacency.getVertices()));
+        heap.push(source, 0);
+
+        while (!heap.empty())
+        {
+            int u = heap.popMin();
+            Length du = tree.distance[static_cast<std::size_t>(u)];
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                int v = adjacency.target(e);
+                std::size_t sv = static_cast<std::size_t>(v);
+                Length candidate = du + weightOf(u, v, adjacency.weight(e));
+                if (candidate < tree.distance[sv])
+                {
+                    if (tree.distance[sv] == ShortestPathTreeOf<W>::UNREACHABLE)
+                    {
+                        heap.push(v, candidate);
+                    }
+                    else
+                    {
+                        heap.decreaseKey(v, candidate);
+                    }
+                    tree.distance[sv] = candidate;
+                    tree.parent[sv] = u;
+                }
+            }
+        }
+        return tree;
+    }
+
+    template <typename W>
+    bool ShortestPaths::virtualSourceSpfa(const BasicCsrAdjacency<W> &adjacency, std::vector<typename WeightTraits<W>::Sum> &distance, std::vector<int> &cycle)
+    {
+        int numVertices = adjacency.getVertices();
+        std::size_t n = static_cast<std::size_t>(numVertices);
+        int root = numVertices; // the virtual source
+
+        distance.assign(n, 0);
+        cycle.clear();
+        std::vector<int> parent(n + 1, root);
+        std::vector<int> depth(n + 1, 1);
+        std::vector<int> nextInOrder(n + 1);
+        std::vector<int> prevInOrder(n + 1);
+        std::vector<char> inTree(n + 1, 1);
+        std::vector<char> queued(n, 1);
+        std::vector<int> queue(n + 1); // ring buffer; a vertex is queued at most once
+        depth[n] = 0;
+        // Preorder root, 0, 1, ..., V - 1, circular
+        for (int v = 0; v <= numVertices; ++v)
+        {
+            std::size_t sv = static_cast<std::size_t>(v);
+            nextInOrder[sv] = v == numVertices ? 0 : v + 1;
+            prevInOrder[sv] = v == 0 ? root : v - 1;
+            if (v < numVertices)
+            {
+                queue[sv] = v;
+            }
+        }
+        if (numVertices == 0)
+        {
+            return true;
+        }
+        std::size_t head = 0, tail = n, pending = n;
+
+        while (pending > 0)
+        {
+            int u = queue[head];
+            head = (head + 1) % queue.size();
+            --pending;
+            std::size_t su = static_cast<std::size_t>(u);
+            queued[su] = 0;
+            if (!inTree[su])
+            {
+                continue; // an ancestor improved since u was queued; u will be queued again if it improves
+            }
+
+            typename WeightTraits<W>::Sum du = distance[su];
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                int v = adjacency.target(e);
+                std::size_t sv = static_cast<std::size_t>(v);
+                if (du + adjacency.weight(e) >= distance[sv])
+                {
+                    continue;
+                }
+                distance[sv] = du + adjacency.weight(e);
+
+                if (inTree[sv])
+                {
+                    // Disassemble the subtree below v: the preorder run after v deeper than v
+                    bool closesCycle = v == u;
+                    int last = v;
+                    for (int x = nextInOrder[sv]; depth[static_cast<std::size_t>(x)] > depth[sv]; x = nextInOrder[static_cast<std::size_t>(x)])
+                    {
+                        closesCycle = closesCycle || x == u;
+                        inTree[static_cast<std::size_t>(x)] = 0;
+                        last = x;
+                    }
+                    if (closesCycle)
+                    {
+                        for (int x = u; x != v; x = parent[static_cast<std::size_t>(x)])
+                        {
+                            cycle.push_back(x);
+                        }
+                        cycle.push_back(v);
+                        std::reverse(cycle.begin(), cycle.end());
+                        return false;
+                    }
+                    int before = prevInOrder[sv];
+                    int after = nextInOrder[static_cast<std::size_t>(last)];
+                    nextInOrder[static_cast<std::size_t>(before)] = after;
+                    prevInOrder[static_cast<std::size_t>(after)] = before;
+                }
+
+                // Hang v directly below u
+                int after = nextInOrder[su];
+                nextInOrder[su] = v;
+                prevInOrder[sv] = u;
+                nextInOrder[sv] = after;
+                prevInOrder[static_cast<std::size_t>(after)] = v;
+                depth[sv] = depth[su] + 1;
+                parent[sv] = u;
+                inTree[sv] = 1;
+
+                if (!queued[sv])
+                {
+                    queued[sv] = 1;
+                    queue[tail] = v;
+                    tail = (tail + 1) % queue.size();
+                    ++pending;
+                }
+            }
+        }
+        return true;
+    }
+
+    // The int routines are compiled once, in ShortestPaths.cpp
+    extern template ShortestPathTree ShortestPaths::compute<int>(const Graph &g, int source);
+    extern template bool ShortestPaths::hasNegativeWeights<int>(const CsrAdjacency &adjacency);
+    extern template ShortestPathTree ShortestPaths::dijkstra<int>(const CsrAdjacency &adjacency, int source);
+    extern template ShortestPathTree ShortestPaths::bellmanFord<int>(const CsrAdjacency &adjacency, int source);
+    extern template std::vector<int> ShortestPaths::findNegativeCycle<int>(const CsrAdjacency &adjacency);
+
+}
+
+#endif
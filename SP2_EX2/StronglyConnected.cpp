@@ -0,0 +1,166 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "StronglyConnected.hpp"
+#include "Graph.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace ariel
+{
+
+    std::vector<std::vector<int>> StronglyConnectedComponents::members() const
+    {
+        std::vector<std::vector<int>> groups(static_cast<std::size_t>(count));
+        for (std::size_t v = 0; v < component.size(); ++v)
+        {
+            groups[static_cast<std::size_t>(component[v])].push_back(static_cast<int>(v));
+        }
+        return groups;
+    }
+
+    int StronglyConnected::components(const CsrStructure &adjacency, std::vector<int> &component)
+    {
+        int numVertices = adjacency.getVertices();
+        std::size_t n = static_cast<std::size_t>(numVertices);
+
+        const int UNSEEN = -1;
+        std::vector<int> index(n, UNSEEN);
+        std::vector<int> low(n, 0);
+        std::vector<bool> onStack(n, false);
+        std::vector<int> stack;                                // Tarjan's vertex stack
+        std::vector<std::pair<int, std::size_t>> calls;        // (vertex, next edge) for the explicit DFS
+        component.assign(n, UNSEEN);
+        int nextIndex = 0;
+        int found = 0;
+
+        for (int root = 0; root < numVertices; ++root)
+        {
+            if (index[static_cast<std::size_t>(root)] != UNSEEN)
+            {
+                continue;
+            }
+            index[static_cast<std::size_t>(root)] = low[static_cast<std::size_t>(root)] = nextIndex++;
+            stack.push_back(root);
+            onStack[static_cast<std::size_t>(root)] = true;
+            calls.push_back(std::make_pair(root, adjacency.rowBegin(root)));
+
+            while (!calls.empty())
+            {
+                int v = calls.back().first;
+                std::size_t sv = static_cast<std::size_t>(v);
+                std::size_t &edge = calls.back().second;
+                if (edge < adjacency.rowEnd(v))
+                {
+                    int w = adjacency.target(edge++);
+                    std::size_t sw = static_cast<std::size_t>(w);
+                    if (index[sw] == UNSEEN)
+                    {
+                        index[sw] = low[sw] = nextIndex++;
+                        stack.push_back(w);
+                        onStack[sw] = true;
+                        calls.push_back(std::make_pair(w, adjacency.rowBegin(w)));
+                    }
+                    else if (onStack[sw])
+                    {
+                        low[sv] = std::min(low[sv], index[sw]);
+                    }
+                    continue;
+                }
+
+                // All edges of v are done: v closes a component if nothing above it reaches further back
+                calls.pop_back();
+                if (low[sv] == index[sv])
+                {
+                    int w;
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[static_cast<std::size_t>(w)] = false;
+                        component[static_cast<std::size_t>(w)] = found;
+                    } while (w != v);
+                    ++found;
+                }
+                if (!calls.empty())
+                {
+                    std::size_t parent = static_cast<std::size_t>(calls.back().first);
+                    low[parent] = std::min(low[parent], low[sv]);
+                }
+            }
+        }
+
+        // Tarjan closes sink components first; reverse the ids to get a topological order
+        for (int &c : component)
+        {
+            c = found - 1 - c;
+        }
+        return found;
+    }
+
+    StronglyConnectedComponents StronglyConnected::compute(const Graph &g)
+    {
+        StronglyConnectedComponents result;
+        result.count = 0;
+        int numVertices = g.getVertices();
+        if (numVertices == 0)
+        {
+            // No components, and the condensation is the empty CSR
+            return result;
+        }
+        const CsrAdjacency &adjacency = g.getCsr();
+        const int UNSEEN = -1;
+        std::vector<int> component;
+        int found = components(adjacency, component);
+        result.count = found;
+
+        // Edges between components, bucketed by source component with a counting sort
+        std::size_t componentCount = static_cast<std::size_t>(found);
+        std::vector<std::size_t> bucket(componentCount + 1, 0);
+        std::vector<Edge> between;
+        for (int u = 0; u < numVertices; ++u)
+        {
+            int from = component[static_cast<std::size_t>(u)];
+            for (std::size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                int to = component[static_cast<std::size_t>(adjacency.target(e))];
+                if (from != to)
+                {
+                    between.push_back({from, to, adjacency.weight(e)});
+                    ++bucket[static_cast<std::size_t>(from) + 1];
+                }
+            }
+        }
+        for (std::size_t c = 0; c < componentCount; ++c)
+        {
+            bucket[c + 1] += bucket[c];
+        }
+        std::vector<Edge> bySource(between.size());
+        for (const Edge &edge : between)
+        {
+            bySource[bucket[static_cast<std::size_t>(edge.from)]++] = edge;
+        }
+
+        // Keep the lightest edge of every component pair: within one source's bucket, lastSource and
+        // slot say whether a target was already seen and where its edge went. O(V + E) overall.
+        std::vector<int> lastSource(componentCount, UNSEEN);
+        std::vector<std::size_t> slot(componentCount, 0);
+        std::vector<Edge> lightest;
+        for (const Edge &edge : bySource)
+        {
+            std::size_t to = static_cast<std::size_t>(edge.to);
+            if (lastSource[to] != edge.from)
+            {
+                lastSource[to] = edge.from;
+                slot[to] = lightest.size();
+                lightest.push_back(edge);
+            }
+            else if (edge.weight < lightest[slot[to]].weight)
+            {
+                lightest[slot[to]].weight = edge.weight;
+            }
+        }
+        result.condensation = CsrAdjacency::fromEdges(found, lightest);
+        result.component.swap(component);
+        return result;
+    }
+
+}
@@ -0,0 +1,39 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef STRONGLY_CONNECTED_HPP
+#define STRONGLY_CONNECTED_HPP
+
+#include "CsrAdjacency.hpp"
+#include "GraphFwd.hpp"
+#include <vector>
+
+namespace ariel
+{
+
+    // Strongly connected components, numbered in topological order of the condensation: every
+    // edge between two components goes from a lower id to a higher one.
+    struct StronglyConnectedComponents
+    {
+        int count;
+        std::vector<int> component; // component id of every vertex
+        // One vertex per component, with an edge a -> b if some edge of the graph leads from a to b,
+        // weighted by the lightest such edge. Always acyclic.
+        CsrAdjacency condensation;
+
+        bool isStronglyConnected() const { return count <= 1; }
+        // Vertices of every component, each list in increasing order
+        std::vector<std::vector<int>> members() const;
+    };
+
+    class StronglyConnected
+    {
+    public:
+        // Tarjan's algorithm with an explicit stack, O(V + E) and no recursion
+        static StronglyConnectedComponents compute(const Graph &g);
+
+        // Just the component ids, for any weight type; returns the number of components
+        static int components(const CsrStructure &adjacency, std::vector<int> &component);
+    };
+
+}
+
+#endif
@@ -1,10 +1,75 @@
 // Id: 211696521 Mail: galh2011@icloud.com
 #include "doctest.h"
+#include "AllPairs.hpp"
 #include "Algorithms.hpp"
+#include "BipartitenessTracker.hpp"
+#include "ConnectivityTracker.hpp"
+#include "ContractionHierarchy.hpp"
+#include "CpuFeatures.hpp"
 #include "Graph.hpp"
+#include "IntDivisor.hpp"
+#include "Landmarks.hpp"
+#include "MatrixProduct.hpp"
+#include "PairingHeap.hpp"
+#include "ParallelBfs.hpp"
+#include "ResultCache.hpp"
+#include "ShortestPaths.hpp"
+#include "StronglyConnected.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;
 
+// Directed edges u -> v with u != v over n vertices, each present with probability 1 / oneIn and
+// weighted uniformly in [1, maxWeight]
+static vector<ariel::Edge> randomEdges(std::mt19937 &rng, int n, unsigned oneIn, int maxWeight)
+{
+    vector<ariel::Edge> edges;
+    for (int u = 0; u < n; ++u)
+    {
+        for (int v = 0; v < n; ++v)
+        {
+            if (u != v && rng() % oneIn == 0)
+            {
+                edges.push_back({u, v, static_cast<int>(rng() % static_cast<unsigned>(maxWeight)) + 1});
+            }
+        }
+    }
+    return edges;
+}
+
+// A side x side grid, vertex r * side + c, with edges both ways between neighbours, each direction
+// weighted uniformly in [1, maxWeight]
+static vector<ariel::Edge> gridEdges(std::mt19937 &rng, int side, int maxWeight)
+{
+    unsigned weights = static_cast<unsigned>(maxWeight);
+    vector<ariel::Edge> edges;
+    for (int r = 0; r < side; ++r)
+    {
+        for (int c = 0; c < side; ++c)
+        {
+            int v = r * side + c;
+            if (c + 1 < side)
+            {
+                edges.push_back({v, v + 1, static_cast<int>(rng() % weights) + 1});
+                edges.push_back({v + 1, v, static_cast<int>(rng() % weights) + 1});
+            }
+            if (r + 1 < side)
+            {
+                edges.push_back({v, v + side, static_cast<int>(rng() % weights) + 1});
+                edges.push_back({v + side, v, static_cast<int>(rng() % weights) + 1});
+            }
+        }
+    }
+    return edges;
+}
+
 TEST_CASE("Algorithms Class Tests")
 {
     SUBCASE("Test isConnected")
@@ -672,3 +737,1595 @@ TEST_CASE("Edge cases")
     g3.loadGraph(oneElementGraph);
     CHECK(g3.toString() == "[42]");
 }
+
+TEST_CASE("Test sparse (CSR) graphs")
+{
+    ariel::Graph dense;
+    vector<vector<int>> graph1 = {
+        {0, 2, 0, 3},
+        {0, 0, 4, 0},
+        {0, 0, 0, 1},
+        {0, 0, 0, 0}};
+    dense.loadGraph(graph1);
+
+    ariel::Graph sparse;
+    vector<ariel::Edge> edges = {{2, 3, 1}, {0, 3, 3}, {1, 2, 4}, {0, 1, 2}};
+    sparse.loadGraph(4, edges);
+    CHECK(sparse.isDense() == false);
+    CHECK(sparse.getCsr() == dense.getCsr());
+    CHECK(sparse == dense);
+    CHECK(sparse.toString() == dense.toString());
+    CHECK(sparse.getCsr().degree(0) == 2);
+    CHECK(sparse.getCsr().edgeWeight(1, 2) == 4);
+    CHECK(sparse.getCsr().edgeWeight(2, 1) == 0);
+    CHECK(sparse.getReverseCsr().degree(3) == 2);
+    CHECK(ariel::Algorithms::shortestPath(sparse, 0, 3) == ariel::Algorithms::shortestPath(dense, 0, 3));
+    CHECK(ariel::Algorithms::isConnected(sparse) == true);
+
+    // A long path is far too large for a dense matrix but trivial in CSR
+    const int n = 200000;
+    vector<ariel::Edge> path;
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        path.push_back({i, i + 1, 1});
+        path.push_back({i + 1, i, 1});
+    }
+    ariel::Graph large;
+    large.loadGraph(n, path);
+    CHECK(ariel::Algorithms::isConnected(large) == true);
+    CHECK(large.getCsr().getEdgeCount() == static_cast<size_t>(2 * (n - 1)));
+
+    CHECK_THROWS(sparse.loadGraph(4, {{0, 4, 1}}));
+    CHECK_THROWS(sparse.loadGraph(4, {{0, 1, 0}}));
+    CHECK_THROWS(sparse.loadGraph(4, {{0, 1, 1}, {0, 1, 2}}));
+    CHECK_THROWS(sparse.loadGraph(0, {}));
+    CHECK_THROWS(large + large);
+}
+
+TEST_CASE("Test flat adjacency matrix layout")
+{
+    vector<vector<int>> graph1 = {
+        {0, 1, 2},
+        {3, 0, 4},
+        {5, 6, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph1);
+
+    const ariel::DenseMatrix &m = g.getAdjacencyMatrix();
+    CHECK(m.size() == 3);
+    CHECK(m.stride() % ariel::DenseMatrix::STRIDE_MULTIPLE == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(m.data()) % ariel::DenseMatrix::ALIGNMENT == 0);
+    CHECK(m.rowData(1) == m.data() + m.stride());
+    CHECK(m[1][2] == 4);
+    CHECK(m[2].size() == 3);
+    CHECK(m.rowData(0)[3] == 0); // padding
+    CHECK(m.toVector() == graph1);
+
+    ariel::Graph copy = g * 2;
+    CHECK(copy.getAdjacencyMatrix()[2][1] == 12);
+    CHECK(copy.getAdjacencyMatrix().rowData(2)[m.stride() - 1] == 0);
+}
+
+TEST_CASE("Test bit-packed adjacency")
+{
+    // Complete bipartite graph between even and odd vertices, dense enough for the bitset kernels
+    const size_t n = 600;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            graph[i][j] = (i % 2 != j % 2) ? 1 : 0;
+        }
+    }
+    ariel::Graph g;
+    g.loadGraph(graph);
+    CHECK(ariel::BitAdjacency::isWorthwhile(g.getCsr()) == true);
+
+    const ariel::BitAdjacency &bits = g.getBitAdjacency();
+    CHECK(bits.getWordsPerRow() == 10);
+    CHECK(bits.hasEdge(0, 599) == true);
+    CHECK(bits.hasEdge(0, 598) == false);
+
+    vector<uint64_t> visited = bits.emptySet();
+    vector<int> order = bits.bfs(0, visited);
+    CHECK(order.size() == n);
+    CHECK(order[1] == 1);
+    CHECK(ariel::BitAdjacency::count(visited) == n);
+    visited = bits.emptySet();
+    CHECK(bits.dfs(5, visited).size() == n);
+
+    CHECK(ariel::Algorithms::isConnected(g) == true);
+    string expected = "The graph is bipartite: A={0, 2, 4, ";
+    CHECK(ariel::Algorithms::isBipartite(g).compare(0, expected.size(), expected) == 0);
+
+    // One same-side edge breaks bipartiteness, cutting every edge into a vertex breaks connectivity
+    graph[0][2] = 1;
+    g.loadGraph(graph);
+    CHECK(ariel::Algorithms::isBipartite(g) == "0");
+    for (size_t i = 0; i < n; ++i)
+    {
+        graph[i][n - 1] = 0;
+    }
+    g.loadGraph(graph);
+    CHECK(ariel::Algorithms::isConnected(g) == false);
+}
+
+TEST_CASE("Test single-source shortest paths")
+{
+    // The cheapest route 0->2->1->3 is not the one with the fewest edges
+    vector<vector<int>> graph1 = {
+        {0, 10, 1, 0},
+        {0, 0, 0, 1},
+        {0, 1, 0, 20},
+        {0, 0, 0, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph1);
+    CHECK(ariel::Algorithms::shortestPath(g, 0, 3) == "0->2->1->3");
+
+    ariel::ShortestPathTree tree = ariel::ShortestPaths::compute(g, 0);
+    CHECK(tree.distance[3] == 3);
+    CHECK(tree.parent[1] == 2);
+    CHECK(tree.pathTo(3) == vector<int>({0, 2, 1, 3}));
+    CHECK(ariel::ShortestPaths::compute(g, 3).reaches(0) == false);
+
+    // Negative weights without a negative cycle take the Bellman-Ford fallback
+    vector<vector<int>> graph2 = {
+        {0, 4, 2, 0},
+        {0, 0, 0, 1},
+        {0, -3, 0, 5},
+        {0, 0, 0, 0}};
+    g.loadGraph(graph2);
+    CHECK(ariel::ShortestPaths::hasNegativeWeights(g.getCsr()) == true);
+    CHECK(ariel::Algorithms::shortestPath(g, 0, 3) == "0->2->1->3");
+    CHECK_THROWS(ariel::Algorithms::shortestPath(g, 0, 4));
+
+    // Dijkstra on the pairing heap agrees with Bellman-Ford on random non-negative graphs
+    std::mt19937 rng(7);
+    for (int round = 0; round < 20; ++round)
+    {
+        const int n = 60;
+        ariel::Graph random;
+        random.loadGraph(n, randomEdges(rng, n, 8, 50));
+        ariel::ShortestPathTree fast = ariel::ShortestPaths::dijkstra(random.getCsr(), round);
+        ariel::ShortestPathTree slow = ariel::ShortestPaths::bellmanFord(random.getCsr(), round);
+        CHECK(fast.distance == slow.distance);
+    }
+
+    ariel::PairingHeap<int> heap(5);
+    heap.push(0, 50);
+    heap.push(1, 30);
+    heap.push(2, 40);
+    heap.push(3, 10);
+    heap.decreaseKey(0, 5);
+    CHECK(heap.popMin() == 0);
+    heap.decreaseKey(2, 1);
+    CHECK(heap.popMin() == 2);
+    CHECK(heap.popMin() == 3);
+    CHECK(heap.popMin() == 1);
+    CHECK(heap.empty());
+}
+
+TEST_CASE("Test shortest path cache")
+{
+    vector<vector<int>> graph1 = {
+        {0, 10, 1, 0},
+        {0, 0, 0, 1},
+        {0, 1, 0, 20},
+        {0, 0, 0, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph1);
+
+    ariel::ShortestPathCache cache(g, 2);
+    CHECK(cache.distanceTo(0, 3) == 3);
+    CHECK(cache.pathTo(0, 1) == vector<int>({0, 2, 1}));
+    CHECK(cache.size() == 1);
+
+    // Later queries from the same source reuse the tree
+    const ariel::ShortestPathTree *first = &cache.tree(0);
+    vector<int> path;
+    cache.pathTo(0, 3, path);
+    CHECK(path == vector<int>({0, 2, 1, 3}));
+    CHECK(&cache.tree(0) == first);
+    CHECK(cache.distances(0)[2] == 1);
+    CHECK(cache.distanceTo(3, 0) == ariel::ShortestPathTree::UNREACHABLE);
+
+    // Least recently used tree is evicted once capacity is exceeded
+    cache.tree(1);
+    CHECK(cache.size() == 2);
+    cache.tree(2);
+    CHECK(cache.size() == 2);
+
+    // Mutating the graph bumps its version and drops every cached tree
+    uint64_t version = g.getVersion();
+    g *= 2;
+    CHECK(g.getVersion() != version);
+    CHECK(cache.distanceTo(0, 3) == 6);
+    CHECK(cache.size() == 1);
+    CHECK_THROWS(ariel::ShortestPathCache(g, 0));
+
+    // Targets are checked like shortestPath's
+    CHECK_THROWS_AS(cache.distanceTo(0, -1), std::invalid_argument);
+    CHECK_THROWS_AS(cache.distanceTo(0, 4), std::invalid_argument);
+    CHECK_THROWS_AS(cache.pathTo(0, 4), std::invalid_argument);
+    CHECK_THROWS_AS(cache.pathTo(0, -1, path), std::invalid_argument);
+    CHECK_THROWS_AS(cache.tree(0).reaches(4), std::invalid_argument);
+}
+
+TEST_CASE("Test blocked matrix product")
+{
+    std::mt19937 rng(11);
+    const size_t sizes[] = {1, 5, 37, 130};
+    for (size_t n : sizes)
+    {
+        vector<vector<int>> m1(n, vector<int>(n)), m2(n, vector<int>(n));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                // Sparse entries, some large enough to overflow and wrap
+                m1[i][j] = rng() % 3 == 0 ? static_cast<int>(rng() % 2000001) - 1000000 : 0;
+                m2[i][j] = rng() % 3 == 0 ? static_cast<int>(rng() % 2000001) - 1000000 : 0;
+            }
+        }
+        vector<vector<int>> expected(n, vector<int>(n, 0));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                uint32_t sum = 0;
+                for (size_t k = 0; k < n; ++k)
+                {
+                    sum += static_cast<uint32_t>(m1[i][k]) * static_cast<uint32_t>(m2[k][j]);
+                }
+                expected[i][j] = static_cast<int>(sum);
+            }
+        }
+        ariel::Graph g1, g2;
+        g1.loadGraph(m1);
+        g2.loadGraph(m2);
+        CHECK((g1 * g2).getAdjacencyMatrix().toVector() == expected);
+
+        ariel::CpuFeatures::setVectorKernelsEnabled(false);
+        CHECK((g1 * g2).getAdjacencyMatrix().toVector() == expected);
+        ariel::CpuFeatures::setVectorKernelsEnabled(true);
+    }
+}
+
+TEST_CASE("Test thread pool")
+{
+    ariel::ThreadPool pool(4);
+    CHECK(pool.size() == 4);
+    vector<int> hits(10000, 0);
+    pool.parallelFor(0, hits.size(), 16, [&hits](size_t first, size_t last)
+                     {
+                         for (size_t i = first; i < last; ++i)
+                         {
+                             ++hits[i];
+                         }
+                     });
+    CHECK(std::count(hits.begin(), hits.end(), 1) == 10000);
+    CHECK_THROWS(pool.parallelFor(0, 1000, 1, [](size_t first, size_t)
+                                  {
+                                      if (first >= 500)
+                                          throw std::runtime_error("chunk failed");
+                                  }));
+}
+
+TEST_CASE("Test semiring products and closures")
+{
+    const int INF = ariel::MatrixProduct::INFINITE_DISTANCE;
+    ariel::DenseMatrix a(vector<vector<int>>({{0, 3, INF}, {INF, 0, -2}, {1, INF, 0}}));
+    ariel::DenseMatrix result;
+    ariel::MatrixProduct::multiply(a, a, result, ariel::Semiring::MinPlus);
+    CHECK(result.toVector() == vector<vector<int>>({{0, 3, 1}, {-1, 0, -2}, {1, 4, 0}}));
+    CHECK(result.rowData(0)[3] == 0); // padding stays zero
+
+    ariel::DenseMatrix w(vector<vector<int>>({{INT_MAX, 5, INT_MIN}, {INT_MIN, INT_MAX, 2}, {7, INT_MIN, INT_MAX}}));
+    ariel::MatrixProduct::multiply(w, w, result, ariel::Semiring::MaxMin);
+    CHECK(result.toVector() == vector<vector<int>>({{INT_MAX, 5, 2}, {2, INT_MAX, 2}, {7, 5, INT_MAX}}));
+
+    // Saturation: huge finite sums clamp instead of wrapping
+    ariel::DenseMatrix big(vector<vector<int>>({{INT_MAX - 1, INT_MAX - 1}, {INT_MIN + 1, INT_MIN + 1}}));
+    ariel::MatrixProduct::multiply(big, big, result, ariel::Semiring::MinPlus);
+    ariel::DenseMatrix scalarResult;
+    ariel::CpuFeatures::setVectorKernelsEnabled(false);
+    ariel::MatrixProduct::multiply(big, big, scalarResult, ariel::Semiring::MinPlus);
+    ariel::CpuFeatures::setVectorKernelsEnabled(true);
+    CHECK(scalarResult == result);
+    CHECK(result.toVector() == vector<vector<int>>({{-1, -1}, {INT_MIN, INT_MIN}}));
+
+    // Closures agree with the single-source routines, with and without the vector kernels
+    std::mt19937 rng(3);
+    const int n = 70;
+    ariel::Graph g;
+    g.loadGraph(n, randomEdges(rng, n, 20, 100));
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        ariel::CpuFeatures::setVectorKernelsEnabled(pass == 0);
+        ariel::DenseMatrix distances = ariel::MatrixProduct::shortestDistances(g);
+        ariel::DenseMatrix reach = ariel::MatrixProduct::reachability(g);
+        for (int s = 0; s < n; s += 7)
+        {
+            ariel::ShortestPathTree tree = ariel::ShortestPaths::compute(g, s);
+            for (int t = 0; t < n; ++t)
+            {
+                size_t st = static_cast<size_t>(s), tt = static_cast<size_t>(t);
+                CHECK(reach[st][tt] == (tree.reaches(t) ? 1 : 0));
+                CHECK(distances[st][tt] == (tree.reaches(t) ? tree.distance[tt] : INF));
+            }
+        }
+    }
+    ariel::CpuFeatures::setVectorKernelsEnabled(true);
+
+    vector<vector<int>> roads = {
+        {0, 4, 9, 0},
+        {0, 0, 0, 3},
+        {0, 0, 0, 6},
+        {0, 0, 0, 0}};
+    g.loadGraph(roads);
+    CHECK(ariel::MatrixProduct::widestPaths(g)[0][3] == 6);
+    CHECK(ariel::MatrixProduct::widestPaths(g)[3][0] == ariel::MatrixProduct::NO_PATH_WIDTH);
+}
+
+
+TEST_CASE("Test blocked Floyd-Warshall")
+{
+    const int INF = ariel::AllPairsShortestPaths::UNREACHABLE;
+    vector<vector<int>> small = {
+        {0, 4, 1, 0},
+        {0, 0, 0, 5},
+        {0, -2, 0, 0},
+        {0, 0, 0, 0}};
+    ariel::Graph g;
+    g.loadGraph(small);
+    ariel::AllPairsShortestPaths apsp = ariel::AllPairsShortestPaths::floydWarshall(g);
+    CHECK(apsp.distance(0, 3) == 4);
+    CHECK(apsp.path(0, 3) == vector<int>({0, 2, 1, 3}));
+    CHECK(apsp.path(2, 2) == vector<int>({2}));
+    CHECK(apsp.distance(3, 0) == INF);
+    CHECK(apsp.path(3, 0).empty());
+    CHECK_FALSE(apsp.hasNegativeCycle());
+    CHECK_THROWS_AS(apsp.distance(0, 4), std::invalid_argument);
+
+    // Several tiles with a ragged last one; paths must add up to the reported distances
+    std::mt19937 rng(8);
+    const int n = 150;
+    g.loadGraph(n, randomEdges(rng, n, 25, 50));
+    ariel::DenseMatrix expected = ariel::MatrixProduct::shortestDistances(g);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        ariel::CpuFeatures::setVectorKernelsEnabled(pass == 0);
+        apsp = ariel::AllPairsShortestPaths::floydWarshall(g);
+        CHECK(apsp.getDistances() == expected);
+        for (int s = 0; s < n; s += 13)
+        {
+            for (int t = 0; t < n; ++t)
+            {
+                vector<int> path = apsp.path(s, t);
+                if (apsp.distance(s, t) == INF)
+                {
+                    CHECK(path.empty());
+                    continue;
+                }
+                int length = 0;
+                for (size_t i = 1; i < path.size(); ++i)
+                {
+                    length += g.getCsr().edgeWeight(path[i - 1], path[i]);
+                }
+                CHECK(path.front() == s);
+                CHECK(path.back() == t);
+                CHECK(length == apsp.distance(s, t));
+            }
+        }
+    }
+    ariel::CpuFeatures::setVectorKernelsEnabled(true);
+
+    g.loadGraph(vector<vector<int>>({{0, 1, 0}, {0, 0, -3}, {1, 0, 0}}));
+    apsp = ariel::AllPairsShortestPaths::floydWarshall(g);
+    CHECK(apsp.hasNegativeCycle());
+    CHECK(apsp.path(0, 2).empty());
+}
+
+
+TEST_CASE("Test Johnson all-pairs shortest paths")
+{
+    // Weights shifted by a random potential: plenty of negative edges but no negative cycle
+    std::mt19937 rng(9);
+    const int n = 120;
+    vector<int> shift(static_cast<size_t>(n));
+    for (int &p : shift)
+    {
+        p = static_cast<int>(rng() % 40);
+    }
+    vector<ariel::Edge> edges = randomEdges(rng, n, 30, 10);
+    for (ariel::Edge &edge : edges)
+    {
+        int w = shift[static_cast<size_t>(edge.to)] - shift[static_cast<size_t>(edge.from)] + edge.weight - 1;
+        edge.weight = w == 0 ? 1 : w;
+    }
+    ariel::Graph g;
+    g.loadGraph(n, edges);
+    CHECK(ariel::ShortestPaths::hasNegativeWeights(g.getCsr()));
+
+    ariel::AllPairsShortestPaths johnson = ariel::AllPairsShortestPaths::johnson(g);
+    ariel::AllPairsShortestPaths floyd = ariel::AllPairsShortestPaths::floydWarshall(g);
+    CHECK_FALSE(johnson.hasNegativeCycle());
+    CHECK(johnson.getDistances() == floyd.getDistances());
+    for (int s = 0; s < n; s += 11)
+    {
+        for (int t = 0; t < n; ++t)
+        {
+            vector<int> path = johnson.path(s, t);
+            CHECK(path.empty() == (johnson.distance(s, t) == ariel::AllPairsShortestPaths::UNREACHABLE));
+            int length = 0;
+            for (size_t i = 1; i < path.size(); ++i)
+            {
+                length += g.getCsr().edgeWeight(path[i - 1], path[i]);
+            }
+            if (!path.empty())
+            {
+                CHECK(length == johnson.distance(s, t));
+            }
+        }
+    }
+
+    // A negative cycle that vertex 0 cannot reach is still found
+    vector<vector<int>> isolated = {
+        {0, 1, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 2},
+        {0, 0, -5, 0}};
+    g.loadGraph(isolated);
+    CHECK(ariel::AllPairsShortestPaths::johnson(g).hasNegativeCycle());
+    CHECK(ariel::AllPairsShortestPaths::johnson(g).path(0, 1).empty());
+}
+
+
+TEST_CASE("Test direction-optimizing BFS")
+{
+    // Reference levels from a plain queue BFS
+    auto serialLevels = [](const ariel::Graph &g, int source)
+    {
+        const ariel::CsrAdjacency &adjacency = g.getCsr();
+        vector<int> depth(static_cast<size_t>(g.getVertices()), ariel::ParallelBfs::UNVISITED);
+        vector<int> queue(1, source);
+        depth[static_cast<size_t>(source)] = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            int u = queue[head];
+            for (size_t e = adjacency.rowBegin(u); e < adjacency.rowEnd(u); ++e)
+            {
+                size_t v = static_cast<size_t>(adjacency.target(e));
+                if (depth[v] == ariel::ParallelBfs::UNVISITED)
+                {
+                    depth[v] = depth[static_cast<size_t>(u)] + 1;
+                    queue.push_back(adjacency.target(e));
+                }
+            }
+        }
+        return depth;
+    };
+
+    // Sparse (stays top-down), medium (switches to bottom-up over the CSR) and dense (bottom-up over
+    // the bit rows) directed graphs
+    std::mt19937 rng(10);
+    const int n = 3000;
+    for (unsigned density : {2000u, 200u, 40u})
+    {
+        ariel::Graph g;
+        g.loadGraph(n, randomEdges(rng, n, density, 1));
+        CHECK(ariel::BitAdjacency::isWorthwhile(g.getCsr()) == (density == 40u));
+        vector<int> expected = serialLevels(g, 0);
+        CHECK(ariel::ParallelBfs::levels(g, 0) == expected);
+        size_t reached = static_cast<size_t>(count_if(expected.begin(), expected.end(), [](int d) { return d != ariel::ParallelBfs::UNVISITED; }));
+        CHECK(ariel::ParallelBfs::reachableCount(g, 0) == reached);
+        CHECK(ariel::Algorithms::isConnected(g) == (reached == static_cast<size_t>(n)));
+    }
+
+    // A long path keeps the frontier at one vertex per level
+    vector<ariel::Edge> chain;
+    for (int v = 0; v + 1 < n; ++v)
+    {
+        chain.push_back({v, v + 1, 1});
+    }
+    ariel::Graph path;
+    path.loadGraph(n, chain);
+    CHECK(ariel::ParallelBfs::levels(path, 0)[static_cast<size_t>(n - 1)] == n - 1);
+    CHECK(ariel::Algorithms::isConnected(path));
+    CHECK(ariel::ParallelBfs::reachableCount(path, 1) == static_cast<size_t>(n - 1));
+    CHECK_THROWS_AS(ariel::ParallelBfs::levels(path, n), std::invalid_argument);
+}
+
+
+TEST_CASE("Test strongly connected components")
+{
+    // {0,1,2} -> {3,4} -> {5}, with 6 on its own pointing into {0,1,2}
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0, 0, 0, 0},
+        {0, 0, 1, 7, 0, 0, 0},
+        {1, 0, 0, 0, 3, 0, 0},
+        {0, 0, 0, 0, 1, 0, 0},
+        {0, 0, 0, 1, 0, 2, 0},
+        {0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 1, 0, 0, 0, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph);
+    ariel::StronglyConnectedComponents scc = ariel::StronglyConnected::compute(g);
+    CHECK(scc.count == 4);
+    CHECK_FALSE(scc.isStronglyConnected());
+    CHECK_FALSE(ariel::Algorithms::isStronglyConnected(g));
+    CHECK(scc.component[0] == scc.component[1]);
+    CHECK(scc.component[1] == scc.component[2]);
+    CHECK(scc.component[3] == scc.component[4]);
+    CHECK(scc.members()[static_cast<size_t>(scc.component[3])] == vector<int>({3, 4}));
+    // Topological numbering and lightest edge between components
+    int big = scc.component[0], pair = scc.component[3], sink = scc.component[5];
+    CHECK(scc.component[6] < big);
+    CHECK(big < pair);
+    CHECK(pair < sink);
+    CHECK(scc.condensation.getEdgeCount() == 3);
+    CHECK(scc.condensation.edgeWeight(big, pair) == 3);
+
+    graph[5][6] = 1; // closes the loop 5 -> 6 -> 2 -> 4 -> 5
+    g.loadGraph(graph);
+    CHECK(ariel::Algorithms::isStronglyConnected(g));
+    CHECK(ariel::StronglyConnected::compute(g).condensation.getEdgeCount() == 0);
+
+    // The empty graph has no components, like isConnected it counts as strongly connected
+    ariel::Graph empty;
+    scc = ariel::StronglyConnected::compute(empty);
+    CHECK(scc.count == 0);
+    CHECK(scc.component.empty());
+    CHECK(scc.condensation.getEdgeCount() == 0);
+    CHECK(ariel::Algorithms::isStronglyConnected(empty));
+
+    // One huge cycle and one huge chain: no recursion, so no stack overflow
+    const int n = 500000;
+    vector<ariel::Edge> ring;
+    for (int v = 0; v < n; ++v)
+    {
+        ring.push_back({v, (v + 1) % n, 1});
+    }
+    ariel::Graph longGraph;
+    longGraph.loadGraph(n, ring);
+    CHECK(ariel::Algorithms::isStronglyConnected(longGraph));
+    ring.pop_back();
+    longGraph.loadGraph(n, ring);
+    scc = ariel::StronglyConnected::compute(longGraph);
+    CHECK(scc.count == n);
+    CHECK(scc.component[0] == 0);
+    CHECK(scc.component[static_cast<size_t>(n - 1)] == n - 1);
+}
+
+
+TEST_CASE("Test iterative cycle detection")
+{
+    // Checks that cycle is a genuine cycle of g in the given mode
+    auto isCycle = [](const ariel::Graph &g, const vector<int> &cycle, ariel::CycleMode mode)
+    {
+        const ariel::CsrAdjacency &adjacency = g.getCsr();
+        for (size_t i = 0; i < cycle.size(); ++i)
+        {
+            int u = cycle[i], v = cycle[(i + 1) % cycle.size()];
+            bool edge = adjacency.edgeWeight(u, v) != 0 || (mode == ariel::CycleMode::Undirected && adjacency.edgeWeight(v, u) != 0);
+            if (!edge)
+            {
+                return false;
+            }
+        }
+        vector<int> sorted = cycle;
+        sort(sorted.begin(), sorted.end());
+        return !cycle.empty() && adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+    };
+
+    ariel::Graph g;
+    vector<vector<int>> ring = {
+        {0, 1, 0, 0, 1},
+        {1, 0, 1, 0, 0},
+        {0, 1, 0, 1, 0},
+        {0, 0, 1, 0, 1},
+        {1, 0, 0, 1, 0}};
+    g.loadGraph(ring);
+    CHECK(ariel::Algorithms::isContainsCycle(g) == "The cycle is: 0->1->2->3->4->0");
+
+    // A pair of opposite edges is a cycle only when directions count
+    vector<vector<int>> pair = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 0, 0}};
+    g.loadGraph(pair);
+    CHECK(ariel::Algorithms::isContainsCycle(g) == "0");
+    CHECK(ariel::Algorithms::isContainsCycle(g, ariel::CycleMode::Directed) == "The cycle is: 0->1->0");
+
+    // A DAG with a diamond has an undirected cycle but no directed one
+    vector<vector<int>> diamond = {
+        {0, 1, 1, 0},
+        {0, 0, 0, 1},
+        {0, 0, 0, 1},
+        {0, 0, 0, 0}};
+    g.loadGraph(diamond);
+    CHECK(ariel::Algorithms::findCycle(g, ariel::CycleMode::Directed).empty());
+    CHECK(isCycle(g, ariel::Algorithms::findCycle(g, ariel::CycleMode::Undirected), ariel::CycleMode::Undirected));
+
+    // Self-loops are cycles of length one in both modes
+    vector<vector<int>> loop = {
+        {0, 1},
+        {0, 5}};
+    g.loadGraph(loop);
+    CHECK(ariel::Algorithms::findCycle(g, ariel::CycleMode::Directed) == vector<int>({1}));
+    CHECK(ariel::Algorithms::findCycle(g, ariel::CycleMode::Undirected) == vector<int>({1}));
+
+    // Sparse layout, a chain far longer than the native stack could recurse through, closed at the end
+    const int n = 300000;
+    vector<ariel::Edge> chain;
+    for (int v = 0; v + 1 < n; ++v)
+    {
+        chain.push_back({v, v + 1, 1});
+    }
+    g.loadGraph(n, chain);
+    CHECK(ariel::Algorithms::isContainsCycle(g, ariel::CycleMode::Directed) == "0");
+    CHECK(ariel::Algorithms::isContainsCycle(g) == "0");
+    chain.push_back({n - 1, n / 2, 1});
+    g.loadGraph(n, chain);
+    vector<int> cycle = ariel::Algorithms::findCycle(g, ariel::CycleMode::Directed);
+    CHECK(cycle.size() == static_cast<size_t>(n - n / 2));
+    CHECK(cycle.front() == n / 2);
+    CHECK(isCycle(g, cycle, ariel::CycleMode::Directed));
+}
+
+
+TEST_CASE("Test whole-graph negative cycle search")
+{
+    // Vertex 0 cannot reach the negative cycle 2 -> 3 -> 2
+    vector<vector<int>> unreachable = {
+        {0, 4, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 1},
+        {0, 0, -3, 0}};
+    ariel::Graph g;
+    g.loadGraph(unreachable);
+    CHECK(ariel::Algorithms::negativeCycle(g) == "Negative cycle found: 3->2");
+    CHECK(ariel::ShortestPaths::findNegativeCycle(g.getCsr()) == vector<int>({3, 2}));
+
+    vector<vector<int>> selfLoop = {
+        {0, 1},
+        {0, -1}};
+    g.loadGraph(selfLoop);
+    CHECK(ariel::Algorithms::negativeCycle(g) == "Negative cycle found: 1");
+
+    // Random graphs agree with Floyd-Warshall, and every reported cycle is real and negative
+    std::mt19937 rng(13);
+    for (int trial = 0; trial < 40; ++trial)
+    {
+        const int n = 60;
+        vector<ariel::Edge> edges = randomEdges(rng, n, 12, 40);
+        for (ariel::Edge &edge : edges)
+        {
+            edge.weight = edge.weight == 4 ? 1 : edge.weight - 4;
+        }
+        g.loadGraph(n, edges);
+        vector<int> cycle = ariel::ShortestPaths::findNegativeCycle(g.getCsr());
+        CHECK(cycle.empty() == !ariel::AllPairsShortestPaths::floydWarshall(g).hasNegativeCycle());
+        long long length = 0;
+        for (size_t i = 0; i < cycle.size(); ++i)
+        {
+            int weight = g.getCsr().edgeWeight(cycle[i], cycle[(i + 1) % cycle.size()]);
+            CHECK(weight != 0);
+            length += weight;
+        }
+        CHECK(length <= 0);
+        if (!cycle.empty())
+        {
+            CHECK(length < 0);
+        }
+    }
+}
+
+
+TEST_CASE("Test dense Bellman-Ford relaxation kernel")
+{
+    auto isNegativeCycle = [](const ariel::Graph &g, const vector<int> &cycle)
+    {
+        long long length = 0;
+        for (size_t i = 0; i < cycle.size(); ++i)
+        {
+            int weight = g.getCsr().edgeWeight(cycle[i], cycle[(i + 1) % cycle.size()]);
+            if (weight == 0)
+            {
+                return false;
+            }
+            length += weight;
+        }
+        return !cycle.empty() && length < 0;
+    };
+
+    // Mostly-full matrices whose size is not a multiple of the vector width
+    std::mt19937 rng(14);
+    for (int trial = 0; trial < 30; ++trial)
+    {
+        const size_t n = 37;
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        for (size_t u = 0; u < n; ++u)
+        {
+            for (size_t v = 0; v < n; ++v)
+            {
+                if (u != v && rng() % 2 == 0)
+                {
+                    // Mostly large weights so some sums saturate at INT_MAX, a few negative ones
+                    matrix[u][v] = rng() % 50 == 0 ? -static_cast<int>(rng() % 30) - 1 : INT_MAX - static_cast<int>(rng() % 1000);
+                }
+            }
+        }
+        ariel::Graph g;
+        g.loadGraph(matrix);
+        CHECK(ariel::ShortestPaths::preferDense(g));
+        bool expected = !ariel::ShortestPaths::findNegativeCycle(g.getCsr()).empty();
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            ariel::CpuFeatures::setVectorKernelsEnabled(pass == 0);
+            vector<int> cycle = ariel::ShortestPaths::findNegativeCycleDense(g.getAdjacencyMatrix());
+            CHECK(!cycle.empty() == expected);
+            if (!cycle.empty())
+            {
+                CHECK(isNegativeCycle(g, cycle));
+            }
+        }
+        ariel::CpuFeatures::setVectorKernelsEnabled(true);
+    }
+
+    // Distances that would pass INT_MIN fall back to the 64-bit search
+    vector<vector<int>> deep = {
+        {0, INT_MIN + 1, 0, 0},
+        {0, 0, INT_MIN + 1, 0},
+        {0, 0, 0, INT_MIN + 1},
+        {5, 0, 0, 0}};
+    ariel::Graph g;
+    g.loadGraph(deep);
+    CHECK(isNegativeCycle(g, ariel::ShortestPaths::findNegativeCycleDense(g.getAdjacencyMatrix())));
+    deep[3][0] = 0;
+    g.loadGraph(deep);
+    CHECK(ariel::ShortestPaths::findNegativeCycleDense(g.getAdjacencyMatrix()).empty());
+    CHECK(ariel::Algorithms::negativeCycle(g) == "No negative cycle found.");
+}
+
+
+TEST_CASE("Test parallel delta-stepping")
+{
+    std::mt19937 rng(15);
+    const int n = 4000;
+    vector<ariel::Edge> edges;
+    for (int u = 0; u < n; ++u)
+    {
+        for (int k = 0; k < 6; ++k)
+        {
+            int v = static_cast<int>(rng() % n);
+            if (v != u)
+            {
+                edges.push_back({u, v, static_cast<int>(rng() % 1000) + 1});
+            }
+        }
+    }
+    sort(edges.begin(), edges.end(), [](const ariel::Edge &a, const ariel::Edge &b)
+         { return a.from != b.from ? a.from < b.from : a.to < b.to; });
+    edges.erase(unique(edges.begin(), edges.end(), [](const ariel::Edge &a, const ariel::Edge &b)
+                       { return a.from == b.from && a.to == b.to; }),
+                edges.end());
+    ariel::Graph g;
+    g.loadGraph(n, edges);
+    const ariel::CsrAdjacency &adjacency = g.getCsr();
+    CHECK(ariel::ShortestPaths::defaultDelta(adjacency) >= 1);
+
+    for (int source : {0, 17, n - 1})
+    {
+        ariel::ShortestPathTree expected = ariel::ShortestPaths::dijkstra(adjacency, source);
+        for (ariel::Distance delta : {ariel::Distance(0), ariel::Distance(1), ariel::Distance(50), ariel::Distance(1) << 40})
+        {
+            ariel::ShortestPathTree tree = ariel::ShortestPaths::deltaStepping(adjacency, source, delta);
+            CHECK(tree.distance == expected.distance);
+            CHECK(tree.parent[static_cast<size_t>(source)] == -1);
+            for (int v = 0; v < n; v += 97)
+            {
+                vector<int> path = tree.pathTo(v);
+                CHECK(path.empty() == !expected.reaches(v));
+                ariel::Distance length = 0;
+                for (size_t i = 1; i < path.size(); ++i)
+                {
+                    length += adjacency.edgeWeight(path[i - 1], path[i]);
+                }
+                if (!path.empty())
+                {
+                    CHECK(path.front() == source);
+                    CHECK(length == expected.distance[static_cast<size_t>(v)]);
+                }
+            }
+        }
+    }
+
+    vector<vector<int>> negative = {
+        {0, -1},
+        {0, 0}};
+    g.loadGraph(negative);
+    CHECK_THROWS_AS(ariel::ShortestPaths::deltaStepping(g.getCsr(), 0), std::invalid_argument);
+    g.loadGraph(vector<vector<int>>({{0, 1}, {0, 0}}));
+    CHECK_THROWS_AS(ariel::ShortestPaths::deltaStepping(g.getCsr(), 0, -5), std::invalid_argument);
+    CHECK_THROWS_AS(ariel::ShortestPaths::deltaStepping(g.getCsr(), 2), std::invalid_argument);
+}
+
+
+TEST_CASE("Test landmark (ALT) point-to-point queries")
+{
+    // A grid with random weights, plus a few one-way shortcuts and a vertex nothing reaches
+    std::mt19937 rng(16);
+    const int side = 40, n = side * side + 1;
+    vector<ariel::Edge> edges = gridEdges(rng, side, 9);
+    edges.push_back({0, side * side - 1, 200});
+    edges.push_back({n - 1, 5, 1});
+    ariel::Graph g;
+    g.loadGraph(n, edges);
+
+    ariel::LandmarkIndex index(g, 8);
+    CHECK(index.getLandmarks().size() == 8);
+    for (int query = 0; query < 60; ++query)
+    {
+        int s = static_cast<int>(rng() % n), t = static_cast<int>(rng() % n);
+        ariel::ShortestPathTree tree = ariel::ShortestPaths::dijkstra(g.getCsr(), s);
+        CHECK(index.distance(s, t) == tree.distance[static_cast<size_t>(t)]);
+        CHECK(index.lowerBound(s, t) <= tree.distance[static_cast<size_t>(t)]);
+        vector<int> path = index.path(s, t);
+        CHECK(path.empty() == !tree.reaches(t));
+        if (!path.empty())
+        {
+            ariel::Distance length = 0;
+            for (size_t i = 1; i < path.size(); ++i)
+            {
+                length += g.getCsr().edgeWeight(path[i - 1], path[i]);
+            }
+            CHECK(path.front() == s);
+            CHECK(path.back() == t);
+            CHECK(length == tree.distance[static_cast<size_t>(t)]);
+        }
+    }
+    CHECK(index.distance(3, n - 1) == ariel::ShortestPathTree::UNREACHABLE);
+    CHECK(index.path(7, 7) == vector<int>({7}));
+
+    // Corner to corner settles far fewer vertices than the whole grid
+    index.distance(side * side - 1, 0);
+    CHECK(index.getLastSettled() < static_cast<size_t>(n) / 2);
+
+    // Tables survive a round trip through a file and are rejected for another graph
+    const char *file = "landmarks_test.alt";
+    index.save(file);
+    ariel::LandmarkIndex loaded = ariel::LandmarkIndex::load(g, file);
+    CHECK(loaded.getLandmarks() == index.getLandmarks());
+    CHECK(loaded.distance(12, 1500) == index.distance(12, 1500));
+    edges.back().weight = 2;
+    ariel::Graph other;
+    other.loadGraph(n, edges);
+    CHECK_THROWS_AS(ariel::LandmarkIndex::load(other, file), std::invalid_argument);
+    std::remove(file);
+    CHECK_THROWS_AS(ariel::LandmarkIndex::load(g, file), std::runtime_error);
+
+    g.loadGraph(n, edges);
+    CHECK_THROWS_AS(index.distance(0, 1), std::logic_error);
+    vector<vector<int>> negative = {{0, -1}, {0, 0}};
+    g.loadGraph(negative);
+    CHECK_THROWS_AS(ariel::LandmarkIndex(g, 1), std::invalid_argument);
+}
+
+
+TEST_CASE("Test contraction hierarchies")
+{
+    // Grid with random two-way weights, some one-way diagonals and a vertex nothing reaches
+    std::mt19937 rng(17);
+    const int side = 30, n = side * side + 1;
+    vector<ariel::Edge> edges = gridEdges(rng, side, 20);
+    for (int r = 0; r + 1 < side; ++r)
+    {
+        for (int c = 0; c + 1 < side; ++c)
+        {
+            if (rng() % 5 == 0)
+            {
+                int v = r * side + c;
+                edges.push_back({v, v + side + 1, static_cast<int>(rng() % 30) + 1});
+            }
+        }
+    }
+    edges.push_back({n - 1, 0, 4});
+    ariel::Graph g;
+    g.loadGraph(n, edges);
+
+    ariel::ContractionHierarchy ch(g);
+    CHECK(ch.getShortcutCount() > 0);
+    CHECK(ch.getPreprocessingSeconds() >= 0);
+    vector<int> ranks;
+    for (int v = 0; v < n; ++v)
+    {
+        ranks.push_back(ch.getRank(v));
+    }
+    sort(ranks.begin(), ranks.end());
+    CHECK(ranks.front() == 0);
+    CHECK(ranks.back() == n - 1);
+    CHECK(adjacent_find(ranks.begin(), ranks.end()) == ranks.end());
+
+    for (int query = 0; query < 80; ++query)
+    {
+        int s = static_cast<int>(rng() % n), t = static_cast<int>(rng() % n);
+        ariel::ShortestPathTree tree = ariel::ShortestPaths::dijkstra(g.getCsr(), s);
+        CHECK(ch.distance(s, t) == tree.distance[static_cast<size_t>(t)]);
+        vector<int> path = ch.path(s, t);
+        CHECK(path.empty() == !tree.reaches(t));
+        if (!path.empty())
+        {
+            ariel::Distance length = 0;
+            for (size_t i = 1; i < path.size(); ++i)
+            {
+                CHECK(g.getCsr().edgeWeight(path[i - 1], path[i]) != 0);
+                length += g.getCsr().edgeWeight(path[i - 1], path[i]);
+            }
+            CHECK(path.front() == s);
+            CHECK(path.back() == t);
+            CHECK(length == tree.distance[static_cast<size_t>(t)]);
+        }
+    }
+    CHECK(ch.distance(0, n - 1) == ariel::ShortestPathTree::UNREACHABLE);
+    CHECK(ch.path(n - 1, n - 1) == vector<int>({n - 1}));
+    ch.distance(0, side * side - 1);
+    CHECK(ch.getLastSettled() < static_cast<size_t>(n) / 4);
+
+    g.loadGraph(n, edges);
+    CHECK_THROWS_AS(ch.distance(0, 1), std::logic_error);
+    CHECK_THROWS_AS(ariel::ContractionHierarchy(g).path(0, n), std::invalid_argument);
+}
+
+
+TEST_CASE("Test incremental connectivity tracking")
+{
+    ariel::DisjointSets sets(5);
+    CHECK(sets.getSetCount() == 5);
+    CHECK(sets.unite(0, 1));
+    CHECK(sets.unite(3, 1));
+    CHECK_FALSE(sets.unite(0, 3));
+    CHECK(sets.same(0, 3));
+    CHECK(sets.setSize(1) == 3);
+    CHECK(sets.getSetCount() == 3);
+    CHECK_THROWS_AS(sets.find(5), std::invalid_argument);
+
+    // Streamed edges agree with a traversal of the symmetric graph after every batch
+    std::mt19937 rng(18);
+    const int n = 400;
+    ariel::ConnectivityTracker tracker(n);
+    vector<vector<int>> matrix(n, vector<int>(n, 0));
+    int batches = 0;
+    while (!tracker.isConnected())
+    {
+        vector<ariel::Edge> batch;
+        for (int k = 0; k < 40; ++k)
+        {
+            int u = static_cast<int>(rng() % n), v = static_cast<int>(rng() % n);
+            batch.push_back({u, v, 1});
+            matrix[static_cast<size_t>(u)][static_cast<size_t>(v)] = matrix[static_cast<size_t>(v)][static_cast<size_t>(u)] = 1;
+        }
+        tracker.addEdges(batch);
+        if (++batches % 10 == 0)
+        {
+            ariel::Graph g;
+            g.loadGraph(matrix);
+            CHECK(tracker.isConnected() == ariel::Algorithms::isConnected(g));
+            CHECK(ariel::ConnectivityTracker(g).getComponentCount() == tracker.getComponentCount());
+        }
+    }
+    CHECK(tracker.getComponentCount() == 1);
+    CHECK(tracker.componentSize(7) == n);
+
+    // Seeded from a graph, directions ignored
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 5, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph);
+    ariel::ConnectivityTracker seeded(g);
+    CHECK(seeded.getComponentCount() == 2);
+    CHECK(seeded.sameComponent(1, 0));
+    CHECK_FALSE(seeded.sameComponent(1, 2));
+    CHECK(seeded.addEdge(2, 1));
+    CHECK_FALSE(seeded.addEdge(0, 3));
+    CHECK(seeded.isConnected());
+}
+
+
+TEST_CASE("Test BipartitenessTracker")
+{
+    // Even cycle stays bipartite; the chord 0 -> 2 closes a triangle
+    ariel::BipartitenessTracker tracker(5);
+    CHECK(tracker.addEdge(0, 1));
+    CHECK(tracker.addEdge(1, 2));
+    CHECK(tracker.addEdge(2, 3));
+    CHECK(tracker.addEdge(3, 0));
+    vector<int> first, second;
+    tracker.partition(first, second);
+    CHECK(first == vector<int>({0, 2, 4}));
+    CHECK(second == vector<int>({1, 3}));
+    CHECK(tracker.getFirstConflict() == std::make_pair(-1, -1));
+    CHECK_FALSE(tracker.addEdge(0, 2));
+    CHECK_FALSE(tracker.addEdge(4, 4));
+    CHECK(tracker.getFirstConflict() == std::make_pair(0, 2));
+    CHECK_THROWS(tracker.partition(first, second));
+    CHECK_THROWS(tracker.addEdge(0, 5));
+
+    // Agrees with Algorithms::isBipartite while random edges stream in
+    const int n = 60;
+    std::mt19937 rng(19);
+    for (int round = 0; round < 20; ++round)
+    {
+        ariel::BipartitenessTracker online(n);
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        bool bipartite = true;
+        while (bipartite)
+        {
+            int u = static_cast<int>(rng() % n), v = static_cast<int>(rng() % n);
+            if (u == v)
+            {
+                continue;
+            }
+            matrix[static_cast<size_t>(u)][static_cast<size_t>(v)] = matrix[static_cast<size_t>(v)][static_cast<size_t>(u)] = 1;
+            bipartite = online.addEdge(u, v);
+            ariel::Graph g;
+            g.loadGraph(matrix);
+            CHECK(bipartite == (ariel::Algorithms::isBipartite(g) != "0"));
+            CHECK(ariel::BipartitenessTracker(g).isBipartite() == bipartite);
+            if (bipartite)
+            {
+                online.partition(first, second);
+                CHECK(first.size() + second.size() == static_cast<size_t>(n));
+                vector<int> side(n, 0);
+                for (int x : second)
+                {
+                    side[static_cast<size_t>(x)] = 1;
+                }
+                for (size_t a = 0; a < static_cast<size_t>(n); ++a)
+                {
+                    for (size_t b = 0; b < static_cast<size_t>(n); ++b)
+                    {
+                        if (matrix[a][b] != 0)
+                        {
+                            CHECK(side[a] != side[b]);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                CHECK(online.getFirstConflict() == std::make_pair(u, v));
+            }
+        }
+    }
+}
+
+
+TEST_CASE("Test memoized algorithm results")
+{
+    ariel::ResultCache &cache = ariel::ResultCache::shared();
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph);
+
+    // First round computes, the second is served from the cache
+    std::uint64_t misses = cache.getMisses(), hits = cache.getHits();
+    CHECK(ariel::Algorithms::isConnected(g) == true);
+    CHECK(ariel::Algorithms::isContainsCycle(g) == "0");
+    CHECK(ariel::Algorithms::isBipartite(g) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK(ariel::Algorithms::negativeCycle(g) == "No negative cycle found.");
+    CHECK(cache.getMisses() == misses + 4);
+    CHECK(ariel::Algorithms::isConnected(g) == true);
+    CHECK(ariel::Algorithms::isContainsCycle(g) == "0");
+    CHECK(ariel::Algorithms::isBipartite(g) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK(ariel::Algorithms::negativeCycle(g) == "No negative cycle found.");
+    CHECK(cache.getMisses() == misses + 4);
+    CHECK(cache.getHits() == hits + 4);
+
+    // The cycle mode is part of the key
+    CHECK(ariel::Algorithms::isContainsCycle(g, ariel::CycleMode::Directed) == "The cycle is: 0->1->0");
+    CHECK(cache.getMisses() == misses + 5);
+
+    // An unmodified copy shares the results; any mutation starts over
+    ariel::Graph copy = g;
+    CHECK(ariel::Algorithms::isBipartite(copy) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK(cache.getMisses() == misses + 5);
+    ++g;
+    CHECK(ariel::Algorithms::isBipartite(g) == "0");
+    CHECK(cache.getMisses() == misses + 6);
+    g.loadGraph(vector<vector<int>>({{0, 0}, {0, 0}}));
+    CHECK(ariel::Algorithms::isConnected(g) == false);
+    g *= 2;
+    CHECK(ariel::Algorithms::isConnected(g) == false);
+    CHECK(cache.getMisses() == misses + 8);
+
+    // Least recently used results are evicted beyond capacity
+    ariel::ResultCache small(2);
+    int computed = 0;
+    std::function<std::string()> compute = [&computed]()
+    { return std::to_string(++computed); };
+    CHECK(small.lookup(ariel::ResultCache::Query::IsConnected, g, 0, compute) == "1");
+    CHECK(small.lookup(ariel::ResultCache::Query::IsBipartite, g, 0, compute) == "2");
+    CHECK(small.lookup(ariel::ResultCache::Query::IsConnected, g, 0, compute) == "1");
+    CHECK(small.lookup(ariel::ResultCache::Query::NegativeCycle, g, 0, compute) == "3");
+    CHECK(small.size() == 2);
+    CHECK(small.lookup(ariel::ResultCache::Query::IsConnected, g, 0, compute) == "1");
+    CHECK(small.lookup(ariel::ResultCache::Query::IsBipartite, g, 0, compute) == "4");
+    CHECK_THROWS(ariel::ResultCache(0));
+}
+
+
+TEST_CASE("Test maintained graph statistics")
+{
+    // Recounts everything from the matrix to check the maintained values against
+    auto checkStatistics = [](const ariel::Graph &g)
+    {
+        vector<vector<int>> matrix = g.getAdjacencyMatrix().toVector();
+        size_t edges = 0;
+        long long weight = 0;
+        for (size_t i = 0; i < matrix.size(); ++i)
+        {
+            int out = 0, in = 0;
+            for (size_t j = 0; j < matrix.size(); ++j)
+            {
+                out += matrix[i][j] != 0 ? 1 : 0;
+                in += matrix[j][i] != 0 ? 1 : 0;
+                edges += matrix[i][j] != 0 ? 1u : 0u;
+                weight += matrix[i][j];
+            }
+            CHECK(g.getOutDegree(static_cast<int>(i)) == out);
+            CHECK(g.getInDegree(static_cast<int>(i)) == in);
+        }
+        CHECK(g.getEdgeCount() == edges);
+        CHECK(g.getTotalWeight() == weight);
+    };
+
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {-1, 0, 2},
+        {0, 3, 1}};
+    ariel::Graph g;
+    g.loadGraph(graph);
+    CHECK(g.getEdgeCount() == 5);
+    CHECK(g.getOutDegree(2) == 2);
+    CHECK(g.getInDegree(1) == 2);
+    CHECK(g.getTotalWeight() == 6);
+    CHECK_THROWS(g.getOutDegree(3));
+
+    vector<vector<int>> otherGraph = {
+        {0, -1, 4},
+        {1, 0, 0},
+        {0, 0, 0}};
+    ariel::Graph other;
+    other.loadGraph(otherGraph);
+    checkStatistics(g + other);
+    checkStatistics(g - other);
+    checkStatistics(-g);
+    checkStatistics(g * 3);
+    checkStatistics(g * 0);
+    checkStatistics(g / 2);
+    checkStatistics(g * other);
+    ++g;
+    checkStatistics(g);
+    --g;
+    --g;
+    checkStatistics(g);
+    g += other;
+    checkStatistics(g);
+    g -= other;
+    g *= -2;
+    checkStatistics(g);
+    g /= 3;
+    checkStatistics(g);
+
+    // Edge-list graphs count from the CSR
+    ariel::Graph sparse;
+    sparse.loadGraph(4, {{0, 1, 2}, {1, 2, -3}, {3, 3, 1}});
+    CHECK(sparse.getEdgeCount() == 3);
+    CHECK(sparse.getTotalWeight() == 0);
+    CHECK(sparse.getInDegree(3) == 1);
+    CHECK(sparse.getOutDegree(3) == 1);
+
+    // Comparisons still follow the edge-subset rule, then total weight
+    ariel::Graph empty, light, heavy;
+    empty.loadGraph(vector<vector<int>>({{0, 0}, {0, 0}}));
+    light.loadGraph(vector<vector<int>>({{0, 1}, {0, 0}}));
+    heavy.loadGraph(vector<vector<int>>({{0, 5}, {0, 0}}));
+    CHECK_FALSE(empty > empty);
+    CHECK(light > empty);
+    CHECK_FALSE(empty > light);
+    CHECK(heavy > light);
+    CHECK_FALSE(light > heavy);
+    CHECK(light != heavy);
+    CHECK(heavy == heavy / 5 * 5);
+}
+
+
+TEST_CASE("Test fused graph expressions")
+{
+    // Odd sizes exercise both the 8-wide packets and the scalar tail of each row
+    std::mt19937 rng(22);
+    for (size_t n : {size_t(1), size_t(7), size_t(19), size_t(70)})
+    {
+        vector<vector<int>> a(n, vector<int>(n)), b(n, vector<int>(n)), c(n, vector<int>(n));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                a[i][j] = static_cast<int>(rng() % 21) - 10;
+                b[i][j] = static_cast<int>(rng() % 3) - 1;
+                c[i][j] = static_cast<int>(rng() % 7);
+            }
+        }
+        ariel::Graph g1, g2, g3;
+        g1.loadGraph(a);
+        g2.loadGraph(b);
+        g3.loadGraph(c);
+
+        vector<vector<int>> expected(n, vector<int>(n));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                expected[i][j] = (-(a[i][j] + b[i][j] - c[i][j] * 2)) / 3;
+            }
+        }
+        for (bool vectorKernels : {true, false})
+        {
+            ariel::CpuFeatures::setVectorKernelsEnabled(vectorKernels);
+            ariel::Graph result = -(g1 + g2 - g3 * 2) / 3;
+            CHECK(result.getAdjacencyMatrix().toVector() == expected);
+            CHECK(result.getEdgeCount() == ariel::Graph(result * 1).getEdgeCount());
+
+            // The target may be an operand; compound operators reuse the same pass
+            ariel::Graph inPlace = g1;
+            inPlace = inPlace + g2 - g3 * 2;
+            inPlace = -inPlace / 3;
+            CHECK(inPlace == result);
+            inPlace -= result;
+            CHECK(inPlace.getEdgeCount() == 0);
+            CHECK(inPlace.getTotalWeight() == 0);
+        }
+        ariel::CpuFeatures::setVectorKernelsEnabled(true);
+    }
+
+    // Errors surface where the expression is built
+    ariel::Graph small, sparse;
+    small.loadGraph(vector<vector<int>>({{0, 1}, {1, 0}}));
+    sparse.loadGraph(2, {{0, 1, 1}});
+    ariel::Graph g;
+    g.loadGraph(vector<vector<int>>({{0, 1, 0}, {1, 0, 1}, {0, 1, 0}}));
+    CHECK_THROWS_AS(g + small * 2, std::invalid_argument);
+    CHECK_THROWS_AS(g * 2 - small, std::invalid_argument);
+    CHECK_THROWS_AS((g + g) / 0, std::invalid_argument);
+    CHECK_THROWS_AS(-sparse, std::logic_error);
+
+    // Assigning over a graph of another size or representation replaces it
+    sparse = g * 2 + g;
+    CHECK(sparse.isDense());
+    CHECK(sparse.getVertices() == 3);
+    CHECK(sparse.toString() == "[0, 3, 0]\n[3, 0, 3]\n[0, 3, 0]");
+    CHECK(sparse.getInDegree(1) == 2);
+}
+
+
+TEST_CASE("Test copy-on-write graph storage")
+{
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 2},
+        {0, 2, 0}};
+    ariel::Graph g;
+    g.loadGraph(graph);
+    const ariel::CsrAdjacency &csr = g.getCsr();
+
+    // Copies share the matrix and whatever was already derived from it
+    ariel::Graph copy = g;
+    CHECK(&copy.getAdjacencyMatrix() == &g.getAdjacencyMatrix());
+    CHECK(&copy.getCsr() == &csr);
+    CHECK(copy == g);
+    ariel::Graph same = +g;
+    CHECK(&same.getAdjacencyMatrix() == &g.getAdjacencyMatrix());
+
+    // Mutating one copy leaves the others as they were
+    ++copy;
+    CHECK(&copy.getAdjacencyMatrix() != &g.getAdjacencyMatrix());
+    CHECK(copy.toString() == "[1, 2, 1]\n[2, 1, 3]\n[1, 3, 1]");
+    CHECK(g.toString() == "[0, 1, 0]\n[1, 0, 2]\n[0, 2, 0]");
+    CHECK(same.toString() == g.toString());
+    CHECK(g.getEdgeCount() == 4);
+    CHECK(copy.getEdgeCount() == 9);
+
+    // The postfix result keeps the old matrix without a copy of its own
+    const ariel::DenseMatrix *before = &same.getAdjacencyMatrix();
+    ariel::Graph old = same--;
+    CHECK(&old.getAdjacencyMatrix() == before);
+    CHECK(old.toString() == "[0, 1, 0]\n[1, 0, 2]\n[0, 2, 0]");
+    CHECK(same.toString() == "[-1, 0, -1]\n[0, -1, 1]\n[-1, 1, -1]");
+
+    // A graph that is the only owner of its matrix is updated in place
+    const ariel::DenseMatrix *owned = &copy.getAdjacencyMatrix();
+    copy *= 2;
+    copy += g;
+    CHECK(&copy.getAdjacencyMatrix() == owned);
+    CHECK(copy.toString() == "[2, 5, 2]\n[5, 2, 8]\n[2, 8, 2]");
+
+    // Self-assignment through a shared matrix reads the old cells
+    ariel::Graph alias = g;
+    alias = alias + g;
+    CHECK(alias.toString() == "[0, 2, 0]\n[2, 0, 4]\n[0, 4, 0]");
+    CHECK(g.toString() == "[0, 1, 0]\n[1, 0, 2]\n[0, 2, 0]");
+    CHECK(&g.getCsr() == &csr);
+
+    // Reloading detaches as well
+    ariel::Graph reloaded = g;
+    reloaded.loadGraph(vector<vector<int>>({{0, 7}, {7, 0}}));
+    CHECK(g.getVertices() == 3);
+    CHECK(reloaded.getVertices() == 2);
+}
+
+
+TEST_CASE("Test reciprocal division and parallel element-wise operators")
+{
+    // The magic-number quotient truncates toward zero exactly like /
+    std::mt19937 rng(24);
+    vector<int> divisors = {1, -1, 2, -2, 3, -3, 7, 10, -10, 641, 1 << 30, -(1 << 30), INT_MAX, INT_MIN, -INT_MAX};
+    for (int k = 0; k < 200; ++k)
+    {
+        divisors.push_back(static_cast<int>(rng()));
+        divisors.push_back(static_cast<int>(rng() % 201) - 100);
+    }
+    vector<int> dividends = {0, 1, -1, 2, -2, INT_MAX, INT_MIN, INT_MIN + 1, INT_MAX - 1};
+    for (int k = 0; k < 500; ++k)
+    {
+        dividends.push_back(static_cast<int>(rng()));
+        dividends.push_back(static_cast<int>(rng() % 2001) - 1000);
+    }
+    for (int d : divisors)
+    {
+        if (d == 0)
+        {
+            continue;
+        }
+        ariel::IntDivisor divisor(d);
+        CHECK(divisor.getDivisor() == d);
+        for (int n : dividends)
+        {
+            if (n == INT_MIN && d == -1)
+            {
+                continue;
+            }
+            if (divisor.divide(n) != n / d)
+            {
+                CHECK(divisor.divide(n) == n / d);
+            }
+        }
+    }
+    CHECK_THROWS_AS(ariel::IntDivisor(0), std::invalid_argument);
+
+    // Large enough to be split into row ranges; the merged statistics must match a recount
+    const size_t n = 700;
+    vector<vector<int>> a(n, vector<int>(n)), b(n, vector<int>(n));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            a[i][j] = static_cast<int>(rng() % 2001) - 1000;
+            b[i][j] = static_cast<int>(rng() % 5) - 2;
+        }
+    }
+    ariel::Graph g1, g2;
+    g1.loadGraph(a);
+    g2.loadGraph(b);
+    for (int d : {3, -7, 1, 64})
+    {
+        for (bool vectorKernels : {true, false})
+        {
+            ariel::CpuFeatures::setVectorKernelsEnabled(vectorKernels);
+            ariel::Graph result = g1;
+            result -= g2;
+            result /= d;
+            --result;
+            vector<vector<int>> cells = result.getAdjacencyMatrix().toVector();
+            size_t edges = 0;
+            long long weight = 0;
+            bool same = true;
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (size_t j = 0; j < n; ++j)
+                {
+                    int expected = (a[i][j] - b[i][j]) / d - 1;
+                    same = same && cells[i][j] == expected;
+                    edges += expected != 0 ? 1u : 0u;
+                    weight += expected;
+                }
+            }
+            CHECK(same);
+            CHECK(result.getEdgeCount() == edges);
+            CHECK(result.getTotalWeight() == weight);
+            ariel::Graph loaded;
+            loaded.loadGraph(cells);
+            for (int v = 0; v < static_cast<int>(n); v += 37)
+            {
+                CHECK(result.getOutDegree(v) == loaded.getOutDegree(v));
+                CHECK(result.getInDegree(v) == loaded.getInDegree(v));
+            }
+        }
+    }
+    ariel::CpuFeatures::setVectorKernelsEnabled(true);
+}
+
+
+// Builds a BasicGraph<W> from an int matrix
+template <typename W>
+static ariel::BasicGraph<W> convertGraph(const vector<vector<int>> &matrix)
+{
+    vector<vector<W>> cells(matrix.size(), vector<W>(matrix.size()));
+    for (size_t i = 0; i < matrix.size(); ++i)
+    {
+        for (size_t j = 0; j < matrix.size(); ++j)
+        {
+            cells[i][j] = static_cast<W>(matrix[i][j]);
+        }
+    }
+    ariel::BasicGraph<W> g;
+    g.loadGraph(cells);
+    return g;
+}
+
+// The generic algorithms must agree with the tuned int ones
+template <typename W>
+static void checkAgainstIntAlgorithms(std::mt19937 &rng)
+{
+    for (int round = 0; round < 40; ++round)
+    {
+        size_t n = 2 + rng() % 9;
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (rng() % 4 == 0)
+                {
+                    matrix[i][j] = static_cast<int>(rng() % 9) - (round % 2 == 0 ? 0 : 2);
+                }
+                if (round % 3 == 0 && j < i)
+                {
+                    matrix[i][j] = matrix[j][i];
+                }
+            }
+        }
+        ariel::Graph expected;
+        expected.loadGraph(matrix);
+        ariel::BasicGraph<W> g = convertGraph<W>(matrix);
+        typedef ariel::BasicAlgorithms<W> Generic;
+        CHECK(Generic::isConnected(g) == ariel::Algorithms::isConnected(expected));
+        CHECK(Generic::isStronglyConnected(g) == ariel::Algorithms::isStronglyConnected(expected));
+        CHECK(Generic::isContainsCycle(g) == ariel::Algorithms::isContainsCycle(expected));
+        CHECK(Generic::isContainsCycle(g, ariel::CycleMode::Directed) == ariel::Algorithms::isContainsCycle(expected, ariel::CycleMode::Directed));
+        CHECK(Generic::isBipartite(g) == ariel::Algorithms::isBipartite(expected));
+        CHECK((Generic::negativeCycle(g) == "No negative cycle found.") == (ariel::Algorithms::negativeCycle(expected) == "No negative cycle found."));
+        CHECK(Generic::shortestPath(g, 0, static_cast<int>(n) - 1) == ariel::Algorithms::shortestPath(expected, 0, static_cast<int>(n) - 1));
+        CHECK(g.getCsr().getTargets() == expected.getCsr().getTargets());
+        CHECK(g.getCsr().getOffsets() == expected.getCsr().getOffsets());
+        CHECK(ariel::ParallelBfs::levels(g, 0) == ariel::ParallelBfs::levels(expected, 0));
+        CHECK(g.getEdgeCount() == expected.getEdgeCount());
+        CHECK(static_cast<long long>(g.getTotalWeight()) == expected.getTotalWeight());
+    }
+}
+
+TEST_CASE("Test graphs over other weight types")
+{
+    std::mt19937 rng(25);
+    checkAgainstIntAlgorithms<std::int8_t>(rng);
+    checkAgainstIntAlgorithms<std::int16_t>(rng);
+    checkAgainstIntAlgorithms<std::int64_t>(rng);
+    checkAgainstIntAlgorithms<double>(rng);
+
+    // Operators follow the int graph's rules
+    ariel::BasicGraph<std::int8_t> a = convertGraph<std::int8_t>({{0, 1, 0}, {1, 0, 1}, {0, 1, 0}});
+    ariel::BasicGraph<std::int8_t> b = convertGraph<std::int8_t>({{0, 1, 1}, {1, 0, 2}, {1, 2, 0}});
+    CHECK((a + b).toString() == "[0, 2, 1]\n[2, 0, 3]\n[1, 3, 0]");
+    CHECK((a * b).toString() == "[1, 0, 2]\n[1, 3, 1]\n[1, 0, 2]");
+    CHECK((-a * 3 / 2).toString() == "[0, -1, 0]\n[-1, 0, -1]\n[0, -1, 0]");
+    CHECK(b > a);
+    CHECK_FALSE(a > b);
+    ariel::BasicGraph<std::int8_t> c = a++;
+    CHECK(c.getEdgeCount() == 4);
+    CHECK(a.getEdgeCount() == 9);
+    CHECK(a.getVersion() != c.getVersion());
+    CHECK_THROWS(a / 0);
+    CHECK_THROWS(a + convertGraph<std::int8_t>({{0}}));
+    CHECK_THROWS(a.getOutDegree(3));
+
+    // Path lengths of 8-bit weights are summed wider
+    vector<vector<int>> chain(20, vector<int>(20, 0));
+    for (size_t v = 0; v + 1 < chain.size(); ++v)
+    {
+        chain[v][v + 1] = 100;
+    }
+    ariel::BasicGraph<std::int8_t> narrow = convertGraph<std::int8_t>(chain);
+    CHECK(narrow.getTotalWeight() == 1900);
+    CHECK(ariel::BasicAlgorithms<std::int8_t>::shortestPath(narrow, 0, 19) == "0->1->2->3->4->5->6->7->8->9->10->11->12->13->14->15->16->17->18->19");
+
+    // Fractional weights pick the cheaper route
+    ariel::BasicGraph<double> costs;
+    costs.loadGraph({{0, 0.5, 2.0, 0}, {0, 0, 0.25, 1.5}, {0, 0, 0, 0.5}, {-0.75, 0, 0, 0}});
+    CHECK(costs.toString() == "[0, 0.5, 2, 0]\n[0, 0, 0.25, 1.5]\n[0, 0, 0, 0.5]\n[-0.75, 0, 0, 0]");
+    CHECK(ariel::BasicAlgorithms<double>::shortestPath(costs, 0, 3) == "0->1->2->3");
+    CHECK(ariel::BasicAlgorithms<double>::negativeCycle(costs) == "No negative cycle found.");
+    costs.loadGraph({{0, 0.5, 0}, {0, 0, 0.25}, {-0.8, 0, 0}});
+    CHECK(ariel::BasicAlgorithms<double>::negativeCycle(costs).find("Negative cycle found: ") == 0);
+    CHECK(ariel::BasicAlgorithms<double>::shortestPath(costs, 0, 2) == "-1");
+    CHECK(costs.getTotalWeight() == doctest::Approx(-0.05));
+
+    // The CSR keeps the narrow weights; lengths are summed in 64 bits
+    ariel::BasicCsrAdjacency<std::int8_t> csr = ariel::BasicCsrAdjacency<std::int8_t>::fromEdges(3, {{0, 1, 100}, {1, 2, 100}, {2, 0, -7}});
+    CHECK(csr.edgeWeight(1, 2) == 100);
+    CHECK(csr.edgeWeight(2, 1) == 0);
+    CHECK(csr.transpose().edgeWeight(0, 2) == -7);
+    CHECK(ariel::ShortestPaths::dijkstra(narrow.getCsr(), 0).distanceTo(19) == 1900);
+    CHECK(ariel::ShortestPaths::bellmanFord(csr, 0).distanceTo(2) == 200);
+    CHECK(ariel::ShortestPaths::findNegativeCycle(csr).empty());
+    CHECK_THROWS_AS(ariel::BasicCsrAdjacency<std::int8_t>::fromEdges(2, {{0, 1, 0}}), std::invalid_argument);
+}
+
+TEST_CASE("Test concurrent queries on a shared graph")
+{
+    vector<vector<int>> graph(64, vector<int>(64, 0));
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        graph[i][(i + 1) % graph.size()] = static_cast<int>(i % 5) + 1;
+        graph[i][(i * 7) % graph.size()] = 2;
+    }
+    ariel::Graph g;
+    g.loadGraph(graph);
+    const ariel::Graph &shared = g;
+
+    // Every thread sees the one view built on first use, not one of its own
+    const int threads = 4;
+    vector<const ariel::CsrAdjacency *> csr(threads), reverse(threads);
+    vector<const ariel::BitAdjacency *> bits(threads);
+    vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+                                 size_t i = static_cast<size_t>(t);
+                                 bits[i] = &shared.getBitAdjacency();
+                                 reverse[i] = &shared.getReverseCsr();
+                                 csr[i] = &shared.getCsr(); });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    for (size_t i = 1; i < csr.size(); ++i)
+    {
+        CHECK(csr[i] == csr[0]);
+        CHECK(reverse[i] == reverse[0]);
+        CHECK(bits[i] == bits[0]);
+    }
+
+    // Algorithms on one graph from several threads agree with a graph nobody else touches
+    ariel::Graph fresh;
+    fresh.loadGraph(graph);
+    std::string bipartite, cycle;
+    ++g;
+    std::thread first([&]()
+                      { bipartite = ariel::Algorithms::isBipartite(shared); });
+    std::thread second([&]()
+                       { cycle = ariel::Algorithms::isContainsCycle(shared, ariel::CycleMode::Directed); });
+    first.join();
+    second.join();
+    ++fresh;
+    CHECK(bipartite == ariel::Algorithms::isBipartite(fresh));
+    CHECK(cycle == ariel::Algorithms::isContainsCycle(fresh, ariel::CycleMode::Directed));
+}
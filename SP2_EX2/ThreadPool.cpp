@@ -0,0 +1,160 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace ariel
+{
+
+    namespace
+    {
+        thread_local bool insidePool = false;
+    }
+
+    struct ThreadPool::Job
+    {
+        const RangeBody *body;
+        std::size_t begin;
+        std::size_t end;
+        std::size_t chunkSize;
+        std::size_t chunks;
+        std::atomic<std::size_t> nextChunk;
+        std::size_t participants; // workers currently inside runChunks, guarded by the pool mutex
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    ThreadPool::ThreadPool(std::size_t threads) : current(nullptr), generation(0), stopping(false)
+    {
+        if (threads == 0)
+        {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 1; i < threads; ++i)
+        {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool &ThreadPool::shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const RangeBody &body)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        std::size_t count = end - begin;
+
+        std::unique_lock<std::mutex> submit(submitMutex, std::try_to_lock);
+        if (workers.empty() || insidePool || !submit.owns_lock() || count <= grain)
+        {
+            body(begin, end);
+            return;
+        }
+
+        Job job;
+        job.body = &body;
+        job.begin = begin;
+        job.end = end;
+        // Aim for a few chunks per thread so uneven chunks still balance out
+        job.chunkSize = std::max(grain, (count + 4 * size() - 1) / (4 * size()));
+        job.chunks = (count + job.chunkSize - 1) / job.chunkSize;
+        job.nextChunk = 0;
+        job.participants = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &job;
+            ++generation;
+        }
+        wake.notify_all();
+
+        insidePool = true;
+        runChunks(job);
+        insidePool = false;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            current = nullptr;
+            finished.wait(lock, [&job]() { return job.participants == 0; });
+        }
+        if (job.error)
+        {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    void ThreadPool::runChunks(Job &job)
+    {
+        for (;;)
+        {
+            std::size_t chunk = job.nextChunk.fetch_add(1);
+            if (chunk >= job.chunks)
+            {
+                return;
+            }
+            std::size_t first = job.begin + chunk * job.chunkSize;
+            std::size_t last = std::min(job.end, first + job.chunkSize);
+            try
+            {
+                (*job.body)(first, last);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job.errorMutex);
+                if (!job.error)
+                {
+                    job.error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        insidePool = true;
+        unsigned long long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wake.wait(lock, [this, &seen]() { return stopping || (current != nullptr && generation != seen); });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+            Job *job = current;
+            ++job->participants;
+
+            lock.unlock();
+            runChunks(*job);
+            lock.lock();
+
+            if (--job->participants == 0)
+            {
+                finished.notify_all();
+            }
+        }
+    }
+
+}
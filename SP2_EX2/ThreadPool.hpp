@@ -0,0 +1,57 @@
+// Id: 211696521 Mail: galh2011@icloud.com
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ariel
+{
+
+    // Fixed set of worker threads for data-parallel loops. The calling thread always takes part in its
+    // own loop, so a pool of size 1 (no workers) simply runs everything inline.
+    class ThreadPool
+    {
+    public:
+        // body(first, last) handles the half-open index range [first, last)
+        typedef std::function<void(std::size_t, std::size_t)> RangeBody;
+
+        // threads counts the caller too; 0 means one per hardware thread
+        explicit ThreadPool(std::size_t threads = 0);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Process-wide pool shared by the graph kernels
+        static ThreadPool &shared();
+
+        std::size_t size() const { return workers.size() + 1; }
+
+        // Splits [begin, end) into chunks of at least grain indices and runs them in parallel, returning
+        // once all are done. The first exception thrown by body is rethrown here. Calls made from inside
+        // a pool thread, or while the pool is busy with another caller's loop, run inline.
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const RangeBody &body);
+
+    private:
+        struct Job;
+
+        void workerLoop();
+        static void runChunks(Job &job);
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::mutex submitMutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        Job *current;
+        unsigned long long generation;
+        bool stopping;
+    };
+
+}
+
+#endif